@@ -26,9 +26,14 @@
 #include <algorithm>
 #include <boost/program_options.hpp>
 #include "bugger/data/BuggerRun.hpp"
+#include "bugger/data/BuggerService.hpp"
+#include "bugger/data/BuggerWorker.hpp"
 #include "bugger/misc/VersionLogger.hpp"
+#include "bugger/modifiers/SimplifyModifier.hpp"
+#include "bugger/modifiers/ComponentModifier.hpp"
 #include "bugger/modifiers/ConstraintModifier.hpp"
 #include "bugger/modifiers/VariableModifier.hpp"
+#include "bugger/modifiers/DomainModifier.hpp"
 #include "bugger/modifiers/CoefficientModifier.hpp"
 #include "bugger/modifiers/FixingModifier.hpp"
 #include "bugger/modifiers/SettingModifier.hpp"
@@ -40,6 +45,8 @@
 #include "bugger/interfaces/ScipInterface.hpp"
 #elif defined(BUGGER_WITH_SOPLEX)
 #include "bugger/interfaces/SoplexInterface.hpp"
+#elif defined(BUGGER_WITH_EXTERNAL)
+#include "bugger/interfaces/ExternalInterface.hpp"
 #endif
 
 typedef
@@ -49,6 +56,8 @@ float
 double
 #elif defined(BUGGER_LONGDOUBLE)
 long double
+#elif defined(BUGGER_DOUBLEDOUBLE)
+bugger::DoubleDouble
 #elif defined(BUGGER_QUAD)
 Quad
 #elif defined(BUGGER_RATIONAL)
@@ -60,35 +69,18 @@ REAL;
 using namespace bugger;
 
 int
-main(int argc, char *argv[])
+bug(const OptionsInfo& optionsInfo, Message& msg, const std::shared_ptr<SolveScheduler::Client>& client)
 {
-   print_header<REAL>( );
-
-   // get the options passed by the user
-   OptionsInfo optionsInfo;
-
-   try
-   {
-      optionsInfo = parseOptions(argc, argv);
-   }
-   catch( const boost::program_options::error &ex )
-   {
-      std::cerr << "Error while parsing the options.\n" << '\n';
-      std::cerr << ex.what( ) << '\n';
-      return 1;
-   }
-
-   if( !optionsInfo.is_complete )
-      return 0;
-
-   Message msg { };
    Num<REAL> num { };
    BuggerParameters parameters { };
    std::shared_ptr<SolverFactory<REAL>> factory { load_solver_factory<REAL>() };
    Vec<std::unique_ptr<BuggerModifier<REAL>>> modifiers { };
 
+   modifiers.emplace_back(new SimplifyModifier<REAL>(msg, num, parameters, factory));
+   modifiers.emplace_back(new ComponentModifier<REAL>(msg, num, parameters, factory));
    modifiers.emplace_back(new ConstraintModifier<REAL>(msg, num, parameters, factory));
    modifiers.emplace_back(new VariableModifier<REAL>(msg, num, parameters, factory));
+   modifiers.emplace_back(new DomainModifier<REAL>(msg, num, parameters, factory));
    modifiers.emplace_back(new CoefficientModifier<REAL>(msg, num, parameters, factory));
    modifiers.emplace_back(new FixingModifier<REAL>(msg, num, parameters, factory));
    SettingModifier<REAL>* setting = new SettingModifier<REAL>(msg, num, parameters, factory);
@@ -135,18 +127,18 @@ main(int argc, char *argv[])
                {
                   paramSet.parseParameter(theoptionstr.c_str( ),
                                           thevaluestr.c_str( ));
-                  fmt::print("set {} = {}\n", theoptionstr, thevaluestr);
+                  msg.info("set {} = {}\n", theoptionstr, thevaluestr);
                }
                catch( const std::exception &e )
                {
-                  fmt::print("parameter '{}' could not be set: {}\n", line,
-                             e.what( ));
+                  msg.info("parameter '{}' could not be set: {}\n", line,
+                           e.what( ));
                }
             }
          }
          else
-            fmt::print("could not read parameter file '{}'\n",
-                       optionsInfo.param_settings_file);
+            msg.info("could not read parameter file '{}'\n",
+                     optionsInfo.param_settings_file);
       }
 
       if( !optionsInfo.unparsed_options.empty( ))
@@ -165,17 +157,17 @@ main(int argc, char *argv[])
                {
                   paramSet.parseParameter(theoptionstr.c_str( ),
                                           thevaluestr.c_str( ));
-                  fmt::print("set {} = {}\n", theoptionstr, thevaluestr);
+                  msg.info("set {} = {}\n", theoptionstr, thevaluestr);
                }
                catch( const std::exception &e )
                {
-                  fmt::print("parameter '{}' could not be set: {}\n",
-                             option, e.what( ));
+                  msg.info("parameter '{}' could not be set: {}\n",
+                           option, e.what( ));
                }
             }
             else
             {
-               fmt::print(
+               msg.info(
                      "parameter '{}' could not be set: value expected\n",
                      option);
             }
@@ -194,10 +186,43 @@ main(int argc, char *argv[])
       parameters.maxstages = modifiers.size( );
    if( parameters.initstage < 0 || parameters.initstage >= parameters.maxstages )
       parameters.initstage = max(parameters.maxstages - 1, 0);
+   if( !optionsInfo.worker_address.empty( ) )
+      return BuggerWorker<REAL>( msg, factory ).serve( optionsInfo.worker_address );
+   if( !optionsInfo.manifest_file.empty( ) )
+      return BuggerService( msg, parameters ).serve( optionsInfo, bug );
    if( optionsInfo.target_settings_file.empty( ) )
       setting->setEnabled(false);
 
-   BuggerRun<REAL>( msg, num, parameters, factory, modifiers ).apply( optionsInfo, setting );
+   BuggerRun<REAL> run( msg, num, parameters, factory, modifiers );
+   run.setSchedulerClient( client );
+   run.apply( optionsInfo, setting );
 
    return 0;
 }
+
+int
+main(int argc, char *argv[])
+{
+   print_header<REAL>( );
+
+   // get the options passed by the user
+   OptionsInfo optionsInfo;
+
+   try
+   {
+      optionsInfo = parseOptions(argc, argv);
+   }
+   catch( const boost::program_options::error &ex )
+   {
+      std::cerr << "Error while parsing the options.\n" << '\n';
+      std::cerr << ex.what( ) << '\n';
+      return 1;
+   }
+
+   if( !optionsInfo.is_complete )
+      return 0;
+
+   Message msg { };
+
+   return bug( optionsInfo, msg, nullptr );
+}
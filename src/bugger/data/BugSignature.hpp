@@ -0,0 +1,192 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BUGGER_DATA_BUGSIGNATURE_HPP__
+#define __BUGGER_DATA_BUGSIGNATURE_HPP__
+
+#include "bugger/data/BuggerParameters.hpp"
+#include "bugger/interfaces/SolverStatus.hpp"
+#include "bugger/io/Message.hpp"
+#include "bugger/misc/Vec.hpp"
+#include <algorithm>
+
+
+namespace bugger
+{
+   /**
+    * signature of the original failure so that reductions do not drift to a different failure
+    * a failure matches if it agrees with the pinned failure in the enabled parts out of return code, solver status,
+    * solver log fingerprint, and solving effort within a factor, while all observed failures are recorded per signature
+    */
+   class BugSignature
+   {
+   public:
+
+      struct Entry
+      {
+         char retcode;
+         SolverStatus status;
+         String fingerprint;
+         bool matched;
+         long long nsolves;
+         long long mineffort;
+         long long maxeffort;
+      };
+
+   private:
+
+      const BuggerParameters& parameters;
+      bool pinned = false;
+      char retcode = 0;
+      SolverStatus status = SolverStatus::kUnknown;
+      String fingerprint { };
+      long long effort = -1;
+      long long ndrifts = 0;
+      Vec<Entry> entries { };
+
+   public:
+
+      explicit BugSignature(const BuggerParameters& _parameters) : parameters(_parameters) { }
+
+      /**
+       * checks whether any part of the signature is enabled
+       * @param parameters
+       */
+      static bool
+      isEnabled(const BuggerParameters& parameters)
+      {
+         return parameters.signature_retcode || parameters.signature_status || parameters.signature_fingerprint
+             || parameters.signature_effort > 0.0;
+      }
+
+      bool
+      isPinned( ) const
+      {
+         return pinned;
+      }
+
+      /**
+       * pins the signature to the given failure
+       * @param result return code and status
+       * @param _effort solving effort or -1 if unknown
+       * @param _fingerprint solver log fingerprint
+       */
+      void
+      pin(const std::pair<char, SolverStatus>& result, long long _effort, const String& _fingerprint)
+      {
+         pinned = true;
+         retcode = result.first;
+         status = result.second;
+         effort = _effort;
+         fingerprint = _fingerprint;
+      }
+
+      /**
+       * checks whether the given failure reproduces the pinned signature
+       * @param result return code and status
+       * @param _effort solving effort or -1 if unknown
+       * @param _fingerprint solver log fingerprint
+       */
+      bool
+      matches(const std::pair<char, SolverStatus>& result, long long _effort, const String& _fingerprint) const
+      {
+         if( !pinned )
+            return true;
+         if( parameters.signature_retcode && result.first != retcode )
+            return false;
+         if( parameters.signature_status && result.second != status )
+            return false;
+         if( parameters.signature_fingerprint && _fingerprint != fingerprint )
+            return false;
+         if( parameters.signature_effort > 0.0 && effort >= 0 && ( _effort < 0
+          || (double)_effort * parameters.signature_effort < (double)effort
+          || (double)_effort > (double)effort * parameters.signature_effort ) )
+            return false;
+         return true;
+      }
+
+      /**
+       * records an observed failure under its signature
+       * @param result return code and status
+       * @param _effort solving effort or -1 if unknown
+       * @param _fingerprint solver log fingerprint
+       * @param matched whether the failure reproduced the pinned signature
+       */
+      void
+      record(const std::pair<char, SolverStatus>& result, long long _effort, const String& _fingerprint, bool matched)
+      {
+         if( !matched )
+            ++ndrifts;
+         for( auto& entry : entries )
+         {
+            if( entry.retcode == result.first && entry.status == result.second && entry.fingerprint == _fingerprint
+             && entry.matched == matched )
+            {
+               ++entry.nsolves;
+               if( _effort >= 0 )
+               {
+                  entry.mineffort = entry.mineffort < 0 ? _effort : std::min(entry.mineffort, _effort);
+                  entry.maxeffort = std::max(entry.maxeffort, _effort);
+               }
+               return;
+            }
+         }
+         entries.push_back({ result.first, result.second, _fingerprint, matched, 1, _effort, _effort });
+      }
+
+      long long
+      getNDrifts( ) const
+      {
+         return ndrifts;
+      }
+
+      const Vec<Entry>&
+      getEntries( ) const
+      {
+         return entries;
+      }
+
+      void
+      print(const Message& msg) const
+      {
+         if( pinned )
+         {
+            msg.info("\nPinned signature: code {} with status {} and effort {}", (int)retcode, status, effort);
+            if( !fingerprint.empty( ) )
+               msg.info(" and fingerprint \"{}\"", fingerprint);
+            msg.info(".\n");
+         }
+         if( entries.empty( ) )
+            return;
+         msg.info("\n {:>18} {:>12} {:>23} {:>12} {:>12} {:>12}   {}\n",
+                  "signatures", "code", "status", "solves", "min effort", "max effort", "fingerprint");
+         for( const auto& entry : entries )
+            msg.info(" {:>18} {:>12} {:>23} {:>12} {:>12} {:>12}   {}\n", entry.matched ? "reproduced" : "drifted",
+                     (int)entry.retcode, entry.status, entry.nsolves, entry.mineffort, entry.maxeffort, entry.fingerprint);
+      }
+   };
+
+} // namespace bugger
+
+#endif
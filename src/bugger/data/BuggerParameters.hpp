@@ -40,18 +40,39 @@ namespace bugger {
       int maxrounds = -1;
       int maxstages = -1;
       double tlim = std::numeric_limits<double>::max();
+      double memlimit = std::numeric_limits<double>::max();
       double feastol = 1e-6;
       double epsilon = 1e-9;
       double zeta = 0.0;
       Vec<int> passcodes = {};
       String debug_filename = "";
+      String status_filename = "";
+      String trace_filename = "";
+      String workers = "";
+      double worker_heartbeat = 5.0;
+      double worker_timeout = 60.0;
+      int service_sessions = 0;
+      int service_threads = 0;
+      bool costmodel = false;
+      bool signature_retcode = false;
+      bool signature_status = false;
+      bool signature_fingerprint = false;
+      double signature_effort = 0.0;
+      bool minimize_effort = false;
+      double effort_margin = 0.0;
+      String log_filename = "";
+      long long replay_limit = -1;
+      double proxy_factor = 0.0;
+      bool history = false;
+      int history_retest = 4;
+      String compression = "";
 
    public:
 
       void
       addParameters( ParameterSet& paramSet )
       {
-         paramSet.addParameter( "mode", "selective bugger mode (-1: reproduce and reduce, 0: only reproduce, 1: only reduce)", mode, -1, 1 );
+         paramSet.addParameter( "mode", "selective bugger mode (-1: reproduce and reduce, 0: only reproduce, 1: only reduce, 2: only replay reduction log)", mode, -1, 2 );
          paramSet.addParameter( "expenditure", "calculate the number of batches by ceiled division of the solving effort defined in the solver interface (-1: use original, 0: keep batches)", expenditure, -1 );
          paramSet.addParameter( "nbatches", "maximum number of batches or 0 for singleton batches", nbatches, 0 );
          paramSet.addParameter( "initround", "initial bugger round or -1 for last round", initround, -1 );
@@ -59,11 +80,34 @@ namespace bugger {
          paramSet.addParameter( "maxrounds", "maximum number of bugger rounds or -1 for no limit", maxrounds, -1 );
          paramSet.addParameter( "maxstages", "maximum number of bugger stages or -1 for number of modifiers", maxstages, -1 );
          paramSet.addParameter( "tlim", "bugger time limit", tlim, 0.0 );
+         paramSet.addParameter( "memlimit", "bugger memory limit in MiB on the resident memory, beyond which batches are evaluated without speculation and the problem is compacted", memlimit, 0.0 );
          paramSet.addParameter( "numerics.feastol", "feasibility tolerance to consider constraints satisfied", feastol, 0.0, 1e-1 );
          paramSet.addParameter( "numerics.epsilon", "epsilon tolerance to consider two values numerically equal", epsilon, 0.0, 1e-1 );
          paramSet.addParameter( "numerics.zeta", "zeta tolerance to consider two values exactly equal", zeta, 0.0, 1e-1 );
          paramSet.addParameter( "passcodes", "ignored return codes separated by blanks (example: 2 3)", passcodes );
          paramSet.addParameter( "debug_filename", "if not empty, current instance is written to this file before every solve", debug_filename );
+         paramSet.addParameter( "status_filename", "if not empty, progress is written atomically in JSON format to this file relative to the output directory", status_filename );
+#ifdef BUGGER_USE_TRACE
+         paramSet.addParameter( "trace_filename", "if not empty, trace events are written in Chrome trace-event format to this file relative to the output directory", trace_filename );
+#endif
+         paramSet.addParameter( "workers", "addresses of solve workers separated by blanks to evaluate batches in parallel (example: unix:/tmp/w1 localhost:7001)", workers );
+         paramSet.addParameter( "worker.heartbeat", "interval in seconds in which busy workers signal that they are alive", worker_heartbeat, 0.0 );
+         paramSet.addParameter( "worker.timeout", "time in seconds without sign of life after which a worker is considered lost", worker_timeout, 0.0 );
+         paramSet.addParameter( "service.sessions", "maximum number of concurrent bugger sessions in service mode or 0 for twice the number of threads", service_sessions, 0 );
+         paramSet.addParameter( "service.threads", "number of solves shared fairly by the sessions in service mode or 0 for number of cores", service_threads, 0 );
+         paramSet.addParameter( "costmodel", "size batches by an online model of the solve costs to maximize the expected reductions per second", costmodel );
+         paramSet.addParameter( "signature.retcode", "accept only batches reproducing the return code of the original failure", signature_retcode );
+         paramSet.addParameter( "signature.status", "accept only batches reproducing the solver status of the original failure", signature_status );
+         paramSet.addParameter( "signature.fingerprint", "accept only batches reproducing the solver log fingerprint of the original failure", signature_fingerprint );
+         paramSet.addParameter( "signature.effort", "accept only batches reproducing the solving effort of the original failure within this factor or 0 for any effort", signature_effort, 0.0 );
+         paramSet.addParameter( "effort.minimize", "accept only batches reproducing the issue with less solving effort than the last accepted one in order to accelerate the reproduction", minimize_effort );
+         paramSet.addParameter( "effort.margin", "relative margin by which the solving effort has to decrease if effort is minimized", effort_margin, 0.0, 1.0 );
+         paramSet.addParameter( "log_filename", "if not empty, accepted reductions are logged to this file relative to the output directory, from which they are replayed in mode 2", log_filename );
+         paramSet.addParameter( "replay_limit", "maximum number of logged batches to replay in mode 2 or -1 for all", replay_limit, -1 );
+         paramSet.addParameter( "proxy.factor", "evaluate batches first by a proxy solve restricted to this factor times the solving effort of the current failure, rejecting batches exceeding it, or 0 for full solves only", proxy_factor, 0.0 );
+         paramSet.addParameter( "history.enabled", "traverse elements by ascending number of rejected batches modifying them over all rounds so that likely essential elements are tested last and together, which changes the order of every modifier", history );
+         paramSet.addParameter( "history.retest", "traverse elements in original order in every this many calls of a modifier to retest the history or 0 for never", history_retest, 0 );
+         paramSet.addParameter( "compression", "extension of the codec compressing the instances and solutions written by the bugger (gz, bz2, zst) in parallel blocks with TBB or empty for none", compression );
       }
    };
 
@@ -25,12 +25,21 @@
 #ifndef __BUGGER_DATA_BUGGERRUN_HPP__
 #define __BUGGER_DATA_BUGGERRUN_HPP__
 
+#include "bugger/data/BugSignature.hpp"
+#include "bugger/data/CostModel.hpp"
+#include "bugger/data/MemoryUsage.hpp"
+#include "bugger/data/ReductionLog.hpp"
+#include "bugger/data/SolveScheduler.hpp"
+#include "bugger/data/StatusFile.hpp"
+#include "bugger/data/WorkerPool.hpp"
 #include "bugger/io/MpsParser.hpp"
 #include "bugger/io/MpsWriter.hpp"
 #include "bugger/io/SolParser.hpp"
 #include "bugger/io/SolWriter.hpp"
 #include "bugger/misc/OptionsParser.hpp"
+#include "bugger/misc/Trace.hpp"
 #include "bugger/modifiers/SettingModifier.hpp"
+#include <boost/filesystem.hpp>
 
 
 namespace bugger
@@ -46,6 +55,7 @@ namespace bugger
       const std::shared_ptr<SolverFactory<REAL>>& factory;
       const Vec<std::unique_ptr<BuggerModifier<REAL>>>& modifiers;
       Vec<ModifierStatus> results;
+      std::shared_ptr<SolveScheduler::Client> client { };
 
    public:
 
@@ -58,6 +68,24 @@ namespace bugger
          return timer.getTime() >= parameters.tlim;
       }
 
+      bool
+      is_memory_exceeded( ) const
+      {
+         return parameters.memlimit < std::numeric_limits<double>::max() && get_resident_memory() > parameters.memlimit * 1048576.0;
+      }
+
+      /**
+       * shares the solve slots of a scheduler with concurrent sessions
+       * @param value client of the scheduler
+       */
+      void
+      setSchedulerClient(const std::shared_ptr<SolveScheduler::Client>& value)
+      {
+         client = value;
+         for( const auto& modifier: modifiers )
+            modifier->setSchedulerClient(value);
+      }
+
       void
       apply(const OptionsInfo& optionsInfo, SettingModifier<REAL>* const setting)
       {
@@ -118,12 +146,41 @@ namespace bugger
          auto solution = std::get<2>(instance).get();
          solution.status = status;
          (void)problem.checkFeasibility(solution, num, msg);
+         if( parameters.mode == 2 )
+         {
+            replay(optionsInfo, setting, settings, problem, solution);
+            writeTrace(optionsInfo);
+            return;
+         }
+         SolverSettings initial_settings { settings };
          long long last_effort = -1;
          std::pair<char, SolverStatus> last_result = { SolverRetcode::OKAY, SolverStatus::kUnknown };
          int last_round = -1;
          int last_modifier = -1;
+         std::shared_ptr<CostModel<REAL>> model { };
+         if( parameters.costmodel )
+         {
+            model = std::make_shared<CostModel<REAL>>( );
+            for( const auto& modifier: modifiers )
+               modifier->setCostModel(model);
+         }
+         std::shared_ptr<BugSignature> signature { };
+         if( BugSignature::isEnabled(parameters) )
+         {
+            signature = std::make_shared<BugSignature>(parameters);
+            for( const auto& modifier: modifiers )
+               modifier->setBugSignature(signature);
+         }
          auto solver = factory->create_solver(msg);
-         solver->doSetUp(settings, problem, solution);
+         {
+            BUGGER_TRACE_SCOPE("solver", "doSetUp");
+            solver->doSetUp(settings, problem, solution);
+         }
+         if( parameters.proxy_factor > 0.0 && !solver->hasLimitedSolve( ) )
+         {
+            msg.warn("Proxy solves disabled since the solver does not limit the solving effort.\n");
+            parameters.proxy_factor = 0.0;
+         }
          if( parameters.mode == 1 )
          {
             if( parameters.expenditure < 0 )
@@ -131,11 +188,27 @@ namespace bugger
          }
          else
          {
-            last_result = solver->solve(Vec<int>{ });
-            last_effort = solver->getSolvingEffort( );
+            double seconds;
+            {
+               SolveScheduler::Slot slot { client };
+               BUGGER_TRACE_SCOPE("solver", "solve");
+               auto start = std::chrono::steady_clock::now( );
+               last_result = solver->solve(Vec<int>{ });
+               last_effort = solver->getSolvingEffort( );
+               seconds = std::chrono::duration<double>(std::chrono::steady_clock::now( ) - start).count( );
+            }
+            if( model )
+               model->observe(CostModel<REAL>::getFeatures(problem), seconds, last_effort);
             msg.info("Original solve returned code {} with status {} and effort {}.\n", (int)last_result.first, last_result.second, last_effort);
+            if( signature && last_result.first != SolverRetcode::OKAY )
+               signature->pin(last_result, last_effort, solver->getFingerprint( ));
+            if( last_result.first != SolverRetcode::OKAY )
+               solver->acceptSolve( );
             if( parameters.mode == 0 )
+            {
+               writeTrace(optionsInfo);
                return;
+            }
             if( parameters.expenditure < 0 && ( parameters.nbatches <= 0 || last_effort <= 0 || (parameters.expenditure = parameters.nbatches * last_effort) / last_effort != parameters.nbatches ) )
             {
                msg.info("Batch adaption disabled.\n");
@@ -143,6 +216,21 @@ namespace bugger
             }
             msg.info("\n");
          }
+         Vec<std::pair<int, long long>> trajectory { };
+         if( parameters.minimize_effort )
+            trajectory.emplace_back(-1, last_effort);
+         std::shared_ptr<WorkerPool<REAL>> pool { };
+         if( !parameters.workers.empty( ) )
+         {
+            pool = std::make_shared<WorkerPool<REAL>>(msg, parameters);
+            if( pool->start( ) >= 1 )
+            {
+               for( const auto& modifier: modifiers )
+                  modifier->setWorkerPool(pool);
+            }
+            else
+               pool.reset( );
+         }
          bool writesetting = setting->isEnabled();
          bool writesolution = false;
          for( const auto& modifier: modifiers )
@@ -153,13 +241,43 @@ namespace bugger
                break;
             }
          }
-         int ending = optionsInfo.problem_file.rfind('.');
-         if( optionsInfo.problem_file.substr(ending + 1) == "gz" ||
-             optionsInfo.problem_file.substr(ending + 1) == "bz2" )
-            ending = optionsInfo.problem_file.rfind('.', ending-1);
-         std::string filename = optionsInfo.problem_file.substr(0, ending) + "_";
+         std::string filename = getInstanceFilename(optionsInfo);
+         std::string compression = getCompressionExtension( );
+
+         std::shared_ptr<ReductionLog<REAL>> reductionlog { };
+         if( !parameters.log_filename.empty( ) )
+         {
+            boost::filesystem::path path { parameters.log_filename };
+            if( path.is_relative( ) && !optionsInfo.output_directory.empty( ) )
+               path = boost::filesystem::path(optionsInfo.output_directory) / path;
+            reductionlog = std::make_shared<ReductionLog<REAL>>( );
+            if( reductionlog->open(path.string( ), problem, initial_settings) )
+            {
+               for( const auto& modifier: modifiers )
+                  modifier->setReductionLog(reductionlog);
+            }
+            else
+            {
+               msg.info("Reduction log on {} failed!\n", path.string( ));
+               reductionlog.reset( );
+            }
+         }
+
+         std::unique_ptr<StatusFile<REAL>> statusfile { };
+         if( !parameters.status_filename.empty( ) )
+         {
+            boost::filesystem::path path { parameters.status_filename };
+            if( path.is_relative( ) && !optionsInfo.output_directory.empty( ) )
+               path = boost::filesystem::path(optionsInfo.output_directory) / path;
+            statusfile = std::unique_ptr<StatusFile<REAL>>( new StatusFile<REAL>(parameters, modifiers, path.string( )) );
+            statusfile->setOriginal(problem);
+            for( const auto& modifier: modifiers )
+               modifier->setProgressCallback([&statusfile](const Problem<REAL>& current) { statusfile->update(current); });
+         }
 
          double time = 0.0;
+         MemoryUsage final_memory { };
+         MemoryUsage peak_memory { };
          {
             Timer timer(time);
 
@@ -168,27 +286,71 @@ namespace bugger
                //TODO: Clean matrix in each round
                //TODO: Simplify solver handling
                //TODO: Free solver afterwards
-               solver = factory->create_solver(msg);
-               solver->doSetUp(settings, problem, solution);
-               auto successwrite = solver->writeInstance(filename + std::to_string(round), writesetting, writesolution);
-               if( !std::get<0>(successwrite) )
-                  msg.info("Settings writer of the solver on {} failed!\n", filename + std::to_string(round) + ".set");
-               if( !std::get<1>(successwrite) )
-                  MpsWriter<REAL>::writeProb(filename + std::to_string(round) + ".mps", problem);
-               if( !std::get<2>(successwrite) )
-                  SolWriter<REAL>::writeSol(filename + std::to_string(round) + ".sol", problem, solution);
+               BUGGER_TRACE_SCOPE("round", "round", round + 1);
+               if( is_memory_exceeded( ) )
+               {
+                  // release spare space of the matrix and cached blocks, which keeps all indices
+                  problem.compress(true);
+                  Arena::local( ).reset( );
+                  Arena::local( ).trim( );
+                  PoolResource::trim( );
+                  msg.info("Memory limit exceeded, problem compacted.\n");
+               }
+               final_memory = MemoryUsage::measure(problem);
+               peak_memory.merge(final_memory);
+               {
+                  BUGGER_TRACE_SCOPE("io", "write");
+                  solver = factory->create_solver(msg);
+                  solver->doSetUp(settings, problem, solution);
+                  auto successwrite = solver->writeInstance(filename + std::to_string(round), writesetting, writesolution);
+                  if( !std::get<0>(successwrite) )
+                     msg.info("Settings writer of the solver on {} failed!\n", filename + std::to_string(round) + ".set");
+                  if( !std::get<1>(successwrite) )
+                     MpsWriter<REAL>::writeProb(filename + std::to_string(round) + ".mps" + compression, problem);
+                  if( !std::get<2>(successwrite) )
+                     SolWriter<REAL>::writeSol(filename + std::to_string(round) + ".sol" + compression, problem, solution);
+               }
 
                if( round >= parameters.maxrounds || is_time_exceeded(timer) )
                   break;
 
+               if( statusfile )
+                  statusfile->startRound(problem, round, stage);
+
+               if( reductionlog )
+                  reductionlog->setRound(round);
+
+               if( pool )
+                  pool->setBase(problem, solution);
+
                // adapt batch number
                if( parameters.expenditure > 0 && last_effort >= 0 )
                   parameters.nbatches = last_effort >= 1 ? (parameters.expenditure - 1) / last_effort + 1 : 0;
 
                msg.info("Round {} Stage {} Batch {}\n", round + 1, stage + 1, parameters.nbatches);
+               msg.info("Memory resident {:.1f} peak {:.1f} - rows {:.1f} columns {:.1f} domains {:.1f} names {:.1f} scratch {:.1f} MiB\n",
+                        MemoryUsage::toMiB(final_memory.resident), MemoryUsage::toMiB(final_memory.peak),
+                        MemoryUsage::toMiB(final_memory.rowmajor), MemoryUsage::toMiB(final_memory.colmajor),
+                        MemoryUsage::toMiB(final_memory.domains), MemoryUsage::toMiB(final_memory.names),
+                        MemoryUsage::toMiB(final_memory.scratch));
+               if( parameters.minimize_effort )
+               {
+                  if( last_effort != trajectory.back( ).second )
+                     trajectory.emplace_back(round, last_effort);
+                  if( last_effort >= 0 && trajectory.front( ).second >= 1 )
+                     msg.info("Effort {} - {:.1f}% of original\n", last_effort, 100.0 * (double)last_effort / (double)trajectory.front( ).second);
+                  else
+                     msg.info("Effort {}\n", last_effort);
+               }
 
                for( int modifier = 0; modifier <= stage && stage < parameters.maxstages; ++modifier )
                {
+                  if( statusfile && modifiers[ modifier ]->isEnabled( ) )
+                     statusfile->startModifier(problem, modifier);
+                  if( parameters.minimize_effort )
+                     modifiers[ modifier ]->setEffortBound(last_effort);
+                  if( parameters.proxy_factor > 0.0 )
+                     modifiers[ modifier ]->setProxyBudget(getProxyBudget(last_effort));
                   results[ modifier ] = modifiers[ modifier ]->run(settings, problem, solution, timer);
 
                   if( results[ modifier ] == ModifierStatus::kSuccessful )
@@ -206,6 +368,7 @@ namespace bugger
                      modifier = stage;
                      ++stage;
                      success = stage;
+                     BUGGER_TRACE_INSTANT("round", "stage", stage + 1);
                   }
                }
             }
@@ -213,11 +376,170 @@ namespace bugger
             assert( is_time_exceeded(timer) || evaluateResults( ) != ModifierStatus::kSuccessful );
          }
 
-         printStats(time, last_result, last_round, last_modifier, last_effort);
+         if( pool )
+         {
+            pool->stop( );
+            msg.info("\nWorkers: {} alive, {} jobs requeued\n", pool->getNWorkers( ), pool->getNRequeued( ));
+            for( const auto& modifier: modifiers )
+               modifier->setWorkerPool(nullptr);
+         }
+         if( model )
+         {
+            for( const auto& modifier: modifiers )
+               modifier->setCostModel(nullptr);
+         }
+         if( signature )
+         {
+            for( const auto& modifier: modifiers )
+               modifier->setBugSignature(nullptr);
+         }
+         if( reductionlog )
+         {
+            reductionlog->appendSettings("final", settings);
+            for( const auto& modifier: modifiers )
+               modifier->setReductionLog(nullptr);
+         }
+         if( statusfile )
+         {
+            statusfile->finish(problem);
+            for( const auto& modifier: modifiers )
+               modifier->setProgressCallback(nullptr);
+         }
+         printStats(time, last_result, last_round, last_modifier, last_effort, final_memory, peak_memory);
+         if( signature )
+            signature->print(msg);
+         if( parameters.minimize_effort )
+            printTrajectory(trajectory, last_effort);
+         writeTrace(optionsInfo);
       }
 
    private:
 
+      /**
+       * provides the prefix of the written instances in the output directory, which is created if necessary
+       * @param optionsInfo
+       */
+      std::string
+      getInstanceFilename(const OptionsInfo& optionsInfo) const
+      {
+         int ending = optionsInfo.problem_file.rfind('.');
+         if( optionsInfo.problem_file.substr(ending + 1) == "gz" ||
+             optionsInfo.problem_file.substr(ending + 1) == "bz2" ||
+             optionsInfo.problem_file.substr(ending + 1) == "zst" )
+            ending = optionsInfo.problem_file.rfind('.', ending-1);
+         std::string filename = optionsInfo.problem_file.substr(0, ending) + "_";
+         if( !optionsInfo.output_directory.empty() )
+         {
+            boost::system::error_code error { };
+            boost::filesystem::create_directories(optionsInfo.output_directory, error);
+            if( error )
+               msg.info("Output directory {} not created: {}\n", optionsInfo.output_directory, error.message());
+            filename = ( boost::filesystem::path(optionsInfo.output_directory) / boost::filesystem::path(filename).filename() ).string();
+         }
+         return filename;
+      }
+
+      /**
+       * provides the extension of the codec compressing the instances and solutions written by the bugger, which is
+       * empty if no codec is selected or it is unavailable
+       */
+      std::string
+      getCompressionExtension( ) const
+      {
+         if( parameters.compression.empty( ) )
+            return "";
+         std::string extension = "." + parameters.compression;
+         if( getCodec(extension) == Codec::kNone )
+         {
+            msg.info("Compression {} not available, files are written uncompressed.\n", parameters.compression);
+            return "";
+         }
+         return extension;
+      }
+
+      /**
+       * applies the reduction log to the instance without solves and writes the result with suffix replay
+       * @param optionsInfo
+       * @param setting
+       * @param settings
+       * @param problem
+       * @param solution
+       */
+      void
+      replay(const OptionsInfo& optionsInfo, SettingModifier<REAL>* const setting, SolverSettings& settings,
+             Problem<REAL>& problem, const Solution<REAL>& solution)
+      {
+         if( parameters.log_filename.empty( ) )
+         {
+            msg.info("Reduction log for replay not specified!\n");
+            return;
+         }
+         std::string filename = getInstanceFilename(optionsInfo);
+         boost::filesystem::path path { parameters.log_filename };
+         if( path.is_relative( ) && !optionsInfo.output_directory.empty( ) )
+            path = boost::filesystem::path(optionsInfo.output_directory) / path;
+         long long nbatches;
+         try
+         {
+            BUGGER_TRACE_SCOPE("io", "replay");
+            nbatches = ReductionLog<REAL>::replay(path.string( ), problem, settings, parameters.replay_limit);
+         }
+         catch( const std::exception& exception )
+         {
+            msg.error("{}\n", exception.what( ));
+            return;
+         }
+         msg.info("\nReplayed {} batches of the reduction log {}.\n", nbatches, path.string( ));
+         BUGGER_TRACE_SCOPE("io", "write");
+         auto solver = factory->create_solver(msg);
+         solver->doSetUp(settings, problem, solution);
+         std::string compression = getCompressionExtension( );
+         auto successwrite = solver->writeInstance(filename + "replay", setting->isEnabled( ), true);
+         if( !std::get<0>(successwrite) )
+            msg.info("Settings writer of the solver on {} failed!\n", filename + "replay.set");
+         if( !std::get<1>(successwrite) )
+            MpsWriter<REAL>::writeProb(filename + "replay.mps" + compression, problem);
+         if( !std::get<2>(successwrite) )
+            SolWriter<REAL>::writeSol(filename + "replay.sol" + compression, problem, solution);
+      }
+
+      void
+      writeTrace(const OptionsInfo& optionsInfo)
+      {
+#ifdef BUGGER_USE_TRACE
+         if( parameters.trace_filename.empty( ) )
+            return;
+         boost::filesystem::path path { parameters.trace_filename };
+         if( path.is_relative( ) && !optionsInfo.output_directory.empty( ) )
+            path = boost::filesystem::path(optionsInfo.output_directory) / path;
+         if( !Tracer::get( ).write(path.string( ), Tracer::session( )) )
+            msg.info("Trace writer on {} failed!\n", path.string( ));
+#else
+         (void)optionsInfo;
+#endif
+      }
+
+      /**
+       * prints the solving effort at the start of every round in which it has changed
+       * @param trajectory pairs of round and effort
+       * @param last_effort final effort
+       */
+      void
+      printTrajectory(const Vec<std::pair<int, long long>>& trajectory, long long last_effort) const
+      {
+         msg.info("\nEffort trajectory:");
+         for( const auto& point: trajectory )
+         {
+            if( point.first < 0 )
+               msg.info(" original {}", point.second);
+            else
+               msg.info(" -> round {} {}", point.first + 1, point.second);
+         }
+         if( trajectory.empty( ) || last_effort != trajectory.back( ).second )
+            msg.info(" -> final {}", last_effort);
+         msg.info("\n");
+      }
+
       ModifierStatus
       evaluateResults( )
       {
@@ -229,8 +551,23 @@ namespace bugger
          return static_cast<ModifierStatus>( largestValue );
       }
 
+      /**
+       * derives the budget of proxy solves from the solving effort of the current failure
+       * @param last_effort
+       * @return budget or -1 if the effort is unknown
+       */
+      long long
+      getProxyBudget(long long last_effort) const
+      {
+         if( last_effort < 0 )
+            return -1;
+         double budget = ceil(parameters.proxy_factor * (double)last_effort);
+         return budget < (double)LLONG_MAX ? (long long)budget : LLONG_MAX;
+      }
+
       void
-      printStats(const double& time, const std::pair<char, SolverStatus>& last_result, int last_round, int last_modifier, long long last_effort)
+      printStats(const double& time, const std::pair<char, SolverStatus>& last_result, int last_round, int last_modifier, long long last_effort,
+                 const MemoryUsage& final_memory, const MemoryUsage& peak_memory)
       {
          msg.info("\n {:>18} {:>12} {:>12} {:>18} {:>12} {:>18} \n",
                   "modifiers", "nb calls", "changes", "success calls(%)", "solves", "execution time(s)");
@@ -240,6 +577,20 @@ namespace bugger
             modifier->printStats(msg);
             nsolves += modifier->getNSolves();
          }
+         if( parameters.proxy_factor > 0.0 )
+         {
+            msg.info("\n {:>18} {:>12} {:>12} {:>12} {:>12} {:>12} {:>12} \n",
+                     "proxy tier", "solves", "bugs", "okays", "limits", "errors", "full solves");
+            for( const auto& modifier: modifiers )
+               modifier->printProxyStats(msg);
+         }
+         msg.info("\n {:>18} {:>12} {:>12} \n", "memory(MiB)", "final", "maximum");
+         msg.info(" {:>18} {:>12.1f} {:>12.1f}\n", "row major", MemoryUsage::toMiB(final_memory.rowmajor), MemoryUsage::toMiB(peak_memory.rowmajor));
+         msg.info(" {:>18} {:>12.1f} {:>12.1f}\n", "column major", MemoryUsage::toMiB(final_memory.colmajor), MemoryUsage::toMiB(peak_memory.colmajor));
+         msg.info(" {:>18} {:>12.1f} {:>12.1f}\n", "domains", MemoryUsage::toMiB(final_memory.domains), MemoryUsage::toMiB(peak_memory.domains));
+         msg.info(" {:>18} {:>12.1f} {:>12.1f}\n", "names", MemoryUsage::toMiB(final_memory.names), MemoryUsage::toMiB(peak_memory.names));
+         msg.info(" {:>18} {:>12.1f} {:>12.1f}\n", "scratch", MemoryUsage::toMiB(final_memory.scratch), MemoryUsage::toMiB(peak_memory.scratch));
+         msg.info(" {:>18} {:>12.1f} {:>12.1f}\n", "resident", MemoryUsage::toMiB(final_memory.resident), MemoryUsage::toMiB(std::max(get_peak_memory(), peak_memory.peak)));
          if( last_round == -1 )
          {
             assert(last_modifier == -1);
@@ -0,0 +1,213 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BUGGER_DATA_BUGGERSERVICE_HPP__
+#define __BUGGER_DATA_BUGGERSERVICE_HPP__
+
+#include "bugger/data/BuggerParameters.hpp"
+#include "bugger/data/SolveScheduler.hpp"
+#include "bugger/io/Message.hpp"
+#include "bugger/misc/OptionsParser.hpp"
+#include "bugger/misc/Trace.hpp"
+#include <boost/filesystem.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+
+namespace bugger
+{
+   /**
+    * batch service bugging the jobs of a manifest concurrently
+    * every line of the manifest holds the arguments of one job as on the command line, where the parameters of the
+    * service serve as defaults, the sessions share the solve threads by a fair share scheduler, and each job writes
+    * its instances and its log including the statistics into a separate directory
+    */
+   class BuggerService
+   {
+   public:
+
+      using Session = std::function<int(const OptionsInfo&, Message&, const std::shared_ptr<SolveScheduler::Client>&)>;
+
+   private:
+
+      struct Job
+      {
+         int line;
+         OptionsInfo options;
+         int code;
+         double time;
+         double usage;
+      };
+
+      const Message& msg;
+      const BuggerParameters& parameters;
+
+   public:
+
+      explicit BuggerService(const Message& _msg, const BuggerParameters& _parameters) : msg(_msg), parameters(_parameters) { }
+
+      /**
+       * bugs all jobs of the manifest
+       * @param optionsInfo options of the service
+       * @param session bugs a single job
+       * @return exit code
+       */
+      int
+      serve(const OptionsInfo& optionsInfo, const Session& session)
+      {
+         Vec<Job> jobs { };
+         int ninvalid = 0;
+         if( !read(optionsInfo, jobs, ninvalid) )
+            return 1;
+         const int nthreads = parameters.service_threads > 0 ? parameters.service_threads : std::max((int)std::thread::hardware_concurrency( ), 1);
+         const int nsessions = std::min(parameters.service_sessions > 0 ? parameters.service_sessions : 2 * nthreads, (int)jobs.size( ));
+         msg.info("Service bugging {} jobs in {} sessions on {} threads.\n", jobs.size( ), nsessions, nthreads);
+         SolveScheduler scheduler { nthreads };
+         std::mutex mutex { };
+         int next = 0;
+         Vec<std::thread> threads { };
+         for( int index = 0; index < nsessions; ++index )
+         {
+            threads.emplace_back([&]( ) {
+               while( true )
+               {
+                  Job* job;
+                  {
+                     std::lock_guard<std::mutex> lock(mutex);
+                     if( next >= (int)jobs.size( ) )
+                        return;
+                     job = &jobs[ next++ ];
+                  }
+                  process(*job, scheduler, session);
+               }
+            });
+         }
+         for( auto& thread: threads )
+            thread.join( );
+         printStats(jobs);
+         if( ninvalid >= 1 )
+            msg.info("{} jobs of the manifest are invalid.\n", ninvalid);
+         for( const auto& job: jobs )
+            if( job.code != 0 )
+               return 1;
+         return ninvalid == 0 ? 0 : 1;
+      }
+
+   private:
+
+      bool
+      read(const OptionsInfo& optionsInfo, Vec<Job>& jobs, int& ninvalid) const
+      {
+         std::ifstream input(optionsInfo.manifest_file);
+         if( !input )
+         {
+            msg.error("Manifest {} could not be read.\n", optionsInfo.manifest_file);
+            return false;
+         }
+         const String directory = optionsInfo.output_directory.empty( ) ? String(".") : optionsInfo.output_directory;
+         int line = 0;
+         for( String text; getline(input, text); )
+         {
+            ++line;
+            std::size_t pos = text.find_first_of('#');
+            if( pos != String::npos )
+               text = text.substr(0, pos);
+            std::vector<std::string> arguments = boost::program_options::split_unix(text);
+            if( arguments.empty( ) )
+               continue;
+            Job job { line, OptionsInfo( ), 1, 0.0, 0.0 };
+            job.options.parse(arguments);
+            if( !job.options.is_complete || job.options.problem_file.empty( ) || !job.options.manifest_file.empty( )
+             || !job.options.worker_address.empty( ) )
+            {
+               msg.error("Job in line {} of manifest {} is invalid.\n", line, optionsInfo.manifest_file);
+               ++ninvalid;
+               continue;
+            }
+            if( job.options.param_settings_file.empty( ) )
+               job.options.param_settings_file = optionsInfo.param_settings_file;
+            job.options.unparsed_options.insert(job.options.unparsed_options.begin( ),
+                                                optionsInfo.unparsed_options.begin( ), optionsInfo.unparsed_options.end( ));
+            if( job.options.output_directory.empty( ) )
+            {
+               String stem = boost::filesystem::path(job.options.problem_file).filename( ).string( );
+               stem = stem.substr(0, stem.find_first_of('.'));
+               job.options.output_directory = ( boost::filesystem::path(directory) / fmt::format("job{}_{}", line, stem) ).string( );
+            }
+            jobs.push_back(std::move(job));
+         }
+         return true;
+      }
+
+      void
+      process(Job& job, SolveScheduler& scheduler, const Session& session) const
+      {
+         boost::system::error_code error { };
+         boost::filesystem::create_directories(job.options.output_directory, error);
+         const String filename = ( boost::filesystem::path(job.options.output_directory) / "bugger.log" ).string( );
+         std::ofstream log(filename);
+         if( error || !log )
+         {
+            msg.error("Job in line {} could not open log {}.\n", job.line, filename);
+            return;
+         }
+         msg.info("Job in line {} started in {}.\n", job.line, job.options.output_directory);
+         Message message { };
+         message.setOutputCallback([](int, const char* data, std::size_t size, void* usrdata) {
+            static_cast<std::ofstream*>(usrdata)->write(data, size).flush( );
+         }, &log);
+         auto start = std::chrono::steady_clock::now( );
+         auto client = scheduler.enroll( );
+         BUGGER_TRACE_SESSION( );
+         try
+         {
+            job.code = session(job.options, message, client);
+         }
+         catch( const std::exception& exception )
+         {
+            message.error("Job aborted: {}\n", exception.what( ));
+            job.code = 1;
+         }
+         job.time = std::chrono::duration<double>(std::chrono::steady_clock::now( ) - start).count( );
+         job.usage = client->getTime( );
+         msg.info("Job in line {} finished with code {} after {:.3f} seconds.\n", job.line, job.code, job.time);
+      }
+
+      void
+      printStats(const Vec<Job>& jobs) const
+      {
+         msg.info("\n {:>10} {:>8} {:>18} {:>18}  {}\n", "line", "code", "execution time(s)", "solving time(s)", "directory");
+         for( const auto& job: jobs )
+            msg.info(" {:>10} {:>8} {:>18.3f} {:>18.3f}  {}\n", job.line, job.code, job.time, job.usage, job.options.output_directory);
+      }
+   };
+
+} // namespace bugger
+
+#endif
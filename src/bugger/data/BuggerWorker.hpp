@@ -0,0 +1,171 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BUGGER_DATA_BUGGERWORKER_HPP__
+#define __BUGGER_DATA_BUGGERWORKER_HPP__
+
+#include "bugger/interfaces/SolverInterface.hpp"
+#include "bugger/io/WorkerProtocol.hpp"
+#include <chrono>
+#include <future>
+
+
+namespace bugger
+{
+   /**
+    * solve worker serving the jobs of bugger sessions one after another
+    * every job is solved by a fresh solver created from the factory of the worker, which therefore should be configured
+    * by the same parameters as the bugger
+    */
+   template <typename REAL>
+   class BuggerWorker
+   {
+   private:
+
+      const Message& msg;
+      const std::shared_ptr<SolverFactory<REAL>>& factory;
+
+   public:
+
+      explicit BuggerWorker(const Message& _msg, const std::shared_ptr<SolverFactory<REAL>>& _factory)
+            : msg(_msg), factory(_factory) { }
+
+      /**
+       * serves sessions on address until the address fails
+       * @param address
+       * @return exit code
+       */
+      int
+      serve(const String& address)
+      {
+         WorkerChannel channel { };
+         if( !channel.listen(address) )
+         {
+            msg.error("Worker can not listen on {}.\n", address);
+            return 1;
+         }
+         msg.info("Worker listening on {}.\n", address);
+         while( channel.accept( ) )
+         {
+            msg.info("Session started.\n");
+            session(channel);
+            channel.close( );
+            msg.info("Session finished.\n");
+         }
+         msg.error("Worker can not accept connections on {}.\n", address);
+         return 1;
+      }
+
+   private:
+
+      void
+      session(WorkerChannel& channel)
+      {
+         WorkerMessage type { };
+         String payload { };
+         WorkerHello hello { };
+         if( !channel.receive(type, payload) || type != WorkerMessage::kHello || !WorkerChannel::unpack(payload, hello) )
+            return;
+         if( hello.signature != WorkerHello::get_signature<REAL>( ) )
+         {
+            msg.warn("Session rejected from build {}.\n", hello.signature);
+            hello.signature = WorkerHello::get_signature<REAL>( );
+            channel.send(WorkerMessage::kHello, WorkerChannel::pack(hello));
+            return;
+         }
+         double heartbeat = hello.heartbeat > 0.0 ? hello.heartbeat : 1.0;
+         if( !channel.send(WorkerMessage::kHello, WorkerChannel::pack(hello)) )
+            return;
+         std::unique_ptr<WorkerBase<REAL>> base { };
+         bool primed = false;
+
+         while( channel.receive(type, payload) )
+         {
+            switch( type )
+            {
+            case WorkerMessage::kBase:
+               base.reset(new WorkerBase<REAL>( ));
+               if( !WorkerChannel::unpack(payload, *base) )
+                  return;
+               break;
+            case WorkerMessage::kJob:
+            {
+               WorkerJob<REAL> job { };
+               if( !base || !WorkerChannel::unpack(payload, job) || job.base != base->id )
+                  return;
+               Problem<REAL> problem { base->problem };
+               job.delta.apply(problem);
+               // the first setup initializes the solver interface as done by the original solve of the bugger
+               if( !primed )
+               {
+                  SolverSettings settings { job.settings };
+                  factory->create_solver(msg)->doSetUp(settings, problem, base->solution);
+                  primed = true;
+               }
+               WorkerResult result { };
+               result.id = job.id;
+               auto solve = std::async(std::launch::async, [&]( ) {
+                  auto start = std::chrono::steady_clock::now( );
+                  auto solver = factory->create_solver(msg);
+                  solver->doSetUp(job.settings, problem, base->solution);
+                  std::pair<char, SolverStatus> outcome = solver->solve(job.passcodes);
+                  result.retcode = outcome.first;
+                  result.status = outcome.second;
+                  result.effort = solver->getSolvingEffort( );
+                  result.fingerprint = solver->getFingerprint( );
+                  result.time = std::chrono::duration<double>(std::chrono::steady_clock::now( ) - start).count( );
+               });
+               while( solve.wait_for(std::chrono::duration<double>(heartbeat)) != std::future_status::ready )
+               {
+                  if( !channel.send(WorkerMessage::kHeartbeat, String( )) )
+                     break;
+               }
+               try
+               {
+                  solve.get( );
+                  result.valid = true;
+               }
+               catch( const std::exception& exception )
+               {
+                  msg.error("Solve of job {} failed: {}\n", job.id, exception.what( ));
+               }
+               result.settings = std::move(job.settings);
+               if( !channel.send(WorkerMessage::kResult, WorkerChannel::pack(result)) )
+                  return;
+               Arena::local( ).reset( );
+               break;
+            }
+            case WorkerMessage::kShutdown:
+               return;
+            default:
+               msg.warn("Session received unexpected message {}.\n", (int)type);
+               return;
+            }
+         }
+      }
+   };
+
+} // namespace bugger
+
+#endif
@@ -383,103 +383,66 @@ class ConstraintMatrix
       return colsize;
    }
 
-//   template <typename CoeffChanged>
+   /// change existing coefficients to the values of the given unsorted
+   /// triplets, where the last triplet of a coefficient counts and zero values
+   /// remove the coefficient. The triplets are radix sorted by row and column
+   /// as well as column and row and merged into the row and column major
+   /// storage in linear passes, which are run in parallel if TBB is enabled.
    void
-   changeCoefficients( const MatrixBuffer<REAL>& matrixBuffer )
+   changeCoefficients( const ScratchVec<Triplet<REAL>>& triplets )
    {
-      if( matrixBuffer.empty() )
+      if( triplets.empty() )
          return;
 
-      // update row major storage, and pass down the coeffChanged callback
+      const int ntriplets = static_cast<int>( triplets.size() );
+      auto getRow = [&]( int k ) { return std::get<0>( triplets[k] ); };
+      auto getCol = [&]( int k ) { return std::get<1>( triplets[k] ); };
+      auto getVal = [&]( int k ) -> const REAL& {
+         return std::get<2>( triplets[k] );
+      };
+
+      // all buffers are allocated here since the parallel tasks may run on
+      // threads whose scratch arena is never reset, where the counts are only
+      // needed by the counting sort passes
+      int nkeys = -1;
+      if( isCountingSort( ntriplets, getNRows() ) )
+         nkeys = getNRows();
+      if( isCountingSort( ntriplets, getNCols() ) )
+         nkeys = std::max( nkeys, getNCols() );
+      ScratchVec<int> rowmajor( ntriplets );
+      ScratchVec<int> colmajor( ntriplets );
+      ScratchVec<int> rowbuffer( ntriplets );
+      ScratchVec<int> colbuffer( ntriplets );
+      ScratchVec<int> rowcounts( nkeys + 1 );
+      ScratchVec<int> colcounts( nkeys + 1 );
+      ScratchVec<int> rowstarts;
+      ScratchVec<int> colstarts;
+      for( int k = 0; k < ntriplets; ++k )
+         rowmajor[k] = k;
+      colmajor = rowmajor;
+      rowstarts.reserve( ntriplets + 1 );
+      colstarts.reserve( ntriplets + 1 );
+
 #ifdef BUGGER_TBB
       tbb::parallel_invoke(
           [&]() {
 #endif
-             SmallVec<int, 32> buffer;
-             const MatrixEntry<REAL>* iter =
-                 matrixBuffer.template begin<true>( buffer );
-
-             while( iter != matrixBuffer.end() )
-             {
-                int row = iter->row;
-
-                int newsize = cons_matrix.changeRowInplace(
-                    row,
-                    [&]() {
-                       return iter != matrixBuffer.end() && iter->row == row;
-                    },
-                    [&]() {
-                       auto nextval = std::make_pair( iter->col, iter->val );
-                       iter = matrixBuffer.template next<true>( buffer );
-                       return nextval;
-                    } );
-
-                if( newsize != rowsize[row] )
-                {
-//                   switch( newsize )
-//                   {
-//                   case 0:
-//                      activities[row].min = 0;
-//                      activities[row].max = 0;
-//                      break;
-//                   case 1:
-//                      singletonRows.push_back( row );
-//                   default:
-//                      break;
-//                   }
-
-                   rowsize[row] = newsize;
-                }
-             }
+             sortTriplets( rowmajor, rowbuffer, rowcounts, getNCols(), getCol );
+             sortTriplets( rowmajor, rowbuffer, rowcounts, getNRows(), getRow );
+             getStarts( rowmajor, rowstarts, getRow );
+             cons_matrix.changeRowsInplace(
+                 rowmajor, rowstarts, getRow, getCol, getVal,
+                 [this]( int row, int newsize ) { rowsize[row] = newsize; } );
 #ifdef BUGGER_TBB
           },
           [&]() {
 #endif
-             SmallVec<int, 32> buffer2;
-
-             // update col major storage, do not pass down the coeffChanged
-             // callback so that it
-             /// is only called once
-             const MatrixEntry<REAL>* iter2 =
-                 matrixBuffer.template begin<false>( buffer2 );
-
-             while( iter2 != matrixBuffer.end() )
-             {
-                int col = iter2->col;
-
-                int newsize = cons_matrix_transp.changeRowInplace(
-                    col,
-                    [&]() {
-                       return iter2 != matrixBuffer.end() && iter2->col == col;
-                    },
-                    [&]() {
-                       auto nextval = std::make_pair( iter2->row, iter2->val );
-                       iter2 = matrixBuffer.template next<false>( buffer2 );
-                       return nextval;
-                    }
-//                    ,
-//                    []( int, int, REAL, REAL ) {}
-                    );
-
-                if( newsize != colsize[col] )
-                {
-//                   switch( newsize )
-//                   {
-//                   case 0:
-//                      emptyCols.push_back( col );
-//                      break;
-//                   case 1:
-//                      singletonCols.push_back( col );
-//                   default:
-//                      break;
-//                   }
-                   // in case that a singleton var is aggregated and has 2
-                   // appearances and then is reduced again immediately it may
-                   // appear two times in the list -> causes no bug but some
-                   // unneccessary overhead
-                   colsize[col] = newsize;
-                }
-             }
+             sortTriplets( colmajor, colbuffer, colcounts, getNRows(), getRow );
+             sortTriplets( colmajor, colbuffer, colcounts, getNCols(), getCol );
+             getStarts( colmajor, colstarts, getCol );
+             cons_matrix_transp.changeRowsInplace(
+                 colmajor, colstarts, getCol, getRow, getVal,
+                 [this]( int col, int newsize ) { colsize[col] = newsize; } );
 #ifdef BUGGER_TBB
           } );
 #endif
@@ -587,6 +550,53 @@ class ConstraintMatrix
    }
 
  private:
+   /// whether positions are sorted by a counting sort pass, which is the case
+   /// unless the keys outnumber the positions by far
+   static bool
+   isCountingSort( int npositions, int nkeys )
+   {
+      return 16 * static_cast<long long>( npositions ) >= nkeys;
+   }
+
+   /// stable sort of the positions in order by their key in the range 0 to
+   /// nkeys - 1
+   template <typename GetKey>
+   static void
+   sortTriplets( ScratchVec<int>& order, ScratchVec<int>& buffer,
+                 ScratchVec<int>& counts, int nkeys, GetKey&& getKey )
+   {
+      if( !isCountingSort( static_cast<int>( order.size() ), nkeys ) )
+      {
+         std::stable_sort( order.begin(), order.end(), [&]( int a, int b ) {
+            return getKey( a ) < getKey( b );
+         } );
+         return;
+      }
+
+      assert( static_cast<int>( counts.size() ) > nkeys );
+      std::fill( counts.begin(), counts.begin() + nkeys + 1, 0 );
+      for( int k : order )
+         ++counts[getKey( k ) + 1];
+      for( int key = 1; key <= nkeys; ++key )
+         counts[key] += counts[key - 1];
+      for( int k : order )
+         buffer[counts[getKey( k )]++] = k;
+      order.swap( buffer );
+   }
+
+   /// collect the positions in order at which the key changes and the end
+   template <typename GetKey>
+   static void
+   getStarts( const ScratchVec<int>& order, ScratchVec<int>& starts,
+              GetKey&& getKey )
+   {
+      starts.clear();
+      for( int i = 0; i < static_cast<int>( order.size() ); ++i )
+         if( i == 0 || getKey( order[i] ) != getKey( order[i - 1] ) )
+            starts.push_back( i );
+      starts.push_back( static_cast<int>( order.size() ) );
+   }
+
    /// row-major compressed sparse storage (CSR) of the constraint matrix
    SparseStorage<REAL> cons_matrix;
 
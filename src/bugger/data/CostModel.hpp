@@ -0,0 +1,251 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BUGGER_DATA_COSTMODEL_HPP__
+#define __BUGGER_DATA_COSTMODEL_HPP__
+
+#include "bugger/data/Problem.hpp"
+#include <array>
+#include <cmath>
+
+
+namespace bugger
+{
+   /**
+    * online model of the solve costs
+    * the logarithms of solving time and effort are regressed on the logarithms of the active rows, columns, nonzeros,
+    * and integers by recursive least squares with forgetting, so that recent solves weigh more, and the batch size
+    * maximizing the expected reductions per cost is chosen under independent failures of the elements of a batch
+    */
+   template <typename REAL>
+   class CostModel
+   {
+   public:
+
+      enum class Shrink : int
+      {
+         kNone = 0,
+
+         kRows = 1,
+
+         kColumns = 2,
+      };
+
+      static constexpr int NFEATURES = 5;
+      using Features = std::array<double, NFEATURES>;
+
+   private:
+
+      struct Regression
+      {
+         Features weights { };
+         std::array<Features, NFEATURES> covariance { };
+         long long nsamples = 0;
+
+         Regression( )
+         {
+            for( int i = 0; i < NFEATURES; ++i )
+               covariance[ i ][ i ] = 1e3;
+         }
+
+         double
+         predict(const Features& features) const
+         {
+            double value = 0.0;
+            for( int i = 0; i < NFEATURES; ++i )
+               value += weights[ i ] * features[ i ];
+            return value;
+         }
+
+         void
+         update(const Features& features, double target, double forgetting)
+         {
+            Features gain { };
+            double denominator = forgetting;
+            for( int i = 0; i < NFEATURES; ++i )
+            {
+               for( int j = 0; j < NFEATURES; ++j )
+                  gain[ i ] += covariance[ i ][ j ] * features[ j ];
+               denominator += features[ i ] * gain[ i ];
+            }
+            const double error = target - predict(features);
+            for( int i = 0; i < NFEATURES; ++i )
+            {
+               gain[ i ] /= denominator;
+               weights[ i ] += gain[ i ] * error;
+            }
+            Features row { };
+            for( int j = 0; j < NFEATURES; ++j )
+               for( int i = 0; i < NFEATURES; ++i )
+                  row[ j ] += features[ i ] * covariance[ i ][ j ];
+            for( int i = 0; i < NFEATURES; ++i )
+               for( int j = 0; j < NFEATURES; ++j )
+                  covariance[ i ][ j ] = ( covariance[ i ][ j ] - gain[ i ] * row[ j ] ) / forgetting;
+            ++nsamples;
+         }
+      };
+
+      static constexpr double FORGETTING = 0.98;
+      static constexpr long long MINSAMPLES = 2 * NFEATURES;
+
+      Regression time { };
+      Regression effort { };
+      long long nrejected = 0;
+      long long nelements = 0;
+
+   public:
+
+      /**
+       * @param problem
+       * @return intercept and logarithms of the active rows, columns, nonzeros, and integers
+       */
+      static Features
+      getFeatures(const Problem<REAL>& problem)
+      {
+         const auto& rflags = problem.getRowFlags( );
+         const auto& cflags = problem.getColFlags( );
+         const auto& rowsizes = problem.getRowSizes( );
+         double nrows = 0.0;
+         double nnonzeros = 0.0;
+         double ncols = 0.0;
+         double nintegers = 0.0;
+         for( int row = 0; row < problem.getNRows( ); ++row )
+         {
+            if( !rflags[ row ].test(RowFlag::kRedundant) )
+            {
+               nrows += 1.0;
+               nnonzeros += rowsizes[ row ];
+            }
+         }
+         for( int col = 0; col < problem.getNCols( ); ++col )
+         {
+            if( !cflags[ col ].test(ColFlag::kFixed) )
+            {
+               ncols += 1.0;
+               if( cflags[ col ].test(ColFlag::kIntegral) )
+                  nintegers += 1.0;
+            }
+         }
+         return { 1.0, std::log1p(nrows), std::log1p(ncols), std::log1p(nnonzeros), std::log1p(nintegers) };
+      }
+
+      /**
+       * records the costs of a solve
+       * @param features of the solved problem
+       * @param seconds solving time or negative if unknown
+       * @param work solving effort or negative if unknown
+       */
+      void
+      observe(const Features& features, double seconds, long long work)
+      {
+         if( seconds >= 0.0 )
+            time.update(features, std::log(seconds + 1e-3), FORGETTING);
+         if( work >= 0 )
+            effort.update(features, std::log1p((double)work), FORGETTING);
+      }
+
+      /**
+       * records the outcome of a batch over all modifiers, which serves as history of modifiers without own history
+       * @param size number of elements in the batch
+       * @param reproduced whether the issue was preserved
+       */
+      void
+      record(long long size, bool reproduced)
+      {
+         if( !reproduced )
+            ++nrejected;
+         nelements += size;
+      }
+
+      long long
+      getNRejected( ) const
+      {
+         return nrejected;
+      }
+
+      long long
+      getNElements( ) const
+      {
+         return nelements;
+      }
+
+      /**
+       * @param features of the problem to be solved
+       * @return predicted costs in seconds if available, otherwise in effort, or 1 without sufficient history
+       */
+      double
+      predict(const Features& features) const
+      {
+         if( time.nsamples >= MINSAMPLES )
+            return std::exp(time.predict(features));
+         if( effort.nsamples >= MINSAMPLES )
+            return std::exp(effort.predict(features));
+         return 1.0;
+      }
+
+      /**
+       * chooses the batch size maximizing the expected reductions per cost
+       * @param problem current problem
+       * @param nadmissible number of admissible elements
+       * @param nrejected number of rejected batches in the history of the modifier
+       * @param nelements number of elements in the evaluated batches of the modifier
+       * @param shrink dimension reduced by the elements
+       * @return batch size between 1 and nadmissible
+       */
+      long long
+      getBatchSize(const Problem<REAL>& problem, long long nadmissible, long long nrejected, long long nelements,
+                   Shrink shrink) const
+      {
+         const Features features = getFeatures(problem);
+         // probability that a single element is responsible for the issue
+         const double failure = ( nrejected + 1.0 ) / ( nelements + 2.0 );
+         const double active = std::expm1(features[ shrink == Shrink::kColumns ? 2 : 1 ]);
+         long long best = 1;
+         double value = -1.0;
+         for( long long size = 1; size <= nadmissible; size = size < nadmissible ? std::min(nadmissible, std::max(size + 1, size * 5 / 4)) : size + 1 )
+         {
+            Features candidate { features };
+            if( shrink != Shrink::kNone && active >= 1.0 )
+            {
+               const double remaining = std::max(active - size, 0.0);
+               candidate[ shrink == Shrink::kColumns ? 2 : 1 ] = std::log1p(remaining);
+               candidate[ 3 ] = std::log1p(std::expm1(features[ 3 ]) * remaining / active);
+               if( shrink == Shrink::kColumns )
+                  candidate[ 4 ] = std::log1p(std::expm1(features[ 4 ]) * remaining / active);
+            }
+            const double reductions = size * std::pow(1.0 - failure, (double)size);
+            const double rate = reductions / std::max(predict(candidate), 1e-9);
+            if( rate > value )
+            {
+               value = rate;
+               best = size;
+            }
+         }
+         return best;
+      }
+   };
+
+} // namespace bugger
+
+#endif
@@ -0,0 +1,107 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BUGGER_DATA_FAILUREHISTORY_HPP__
+#define __BUGGER_DATA_FAILUREHISTORY_HPP__
+
+#include "bugger/misc/Vec.hpp"
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+
+namespace bugger
+{
+   /**
+    * number of rejected batches per element of a modifier over all rounds
+    * elements are identified by persistent keys, for example the row or column they refer to, so that elements which
+    * turned out to be essential for the issue can be tested last and together
+    */
+   class FailureHistory
+   {
+   private:
+
+      Vec<int> counts { };
+      long long nrejections = 0;
+
+   public:
+
+      /**
+       * provides the number of rejected batches containing the element
+       * @param key
+       */
+      int
+      getCount(int key) const
+      {
+         return key < (int)counts.size( ) ? counts[ key ] : 0;
+      }
+
+      /**
+       * provides the number of rejected elements over all batches
+       */
+      long long
+      getNRejections( ) const
+      {
+         return nrejections;
+      }
+
+      /**
+       * records that the element was part of a rejected batch
+       * @param key
+       */
+      void
+      reject(int key)
+      {
+         assert(key >= 0);
+         if( key >= (int)counts.size( ) )
+            counts.resize(key + 1, 0);
+         ++counts[ key ];
+         ++nrejections;
+      }
+
+      /**
+       * orders the elements stably by ascending number of rejected batches
+       * @param nelements number of elements
+       * @param keys key of every element or empty if elements are their own keys
+       * @return traversal sequence of the elements or empty if no element was rejected
+       */
+      Vec<int>
+      getSequence(int nelements, const Vec<int>& keys) const
+      {
+         assert(keys.empty( ) || (int)keys.size( ) == nelements);
+         Vec<int> sequence { };
+         if( nrejections == 0 )
+            return sequence;
+         sequence.resize(nelements);
+         std::iota(sequence.begin( ), sequence.end( ), 0);
+         std::stable_sort(sequence.begin( ), sequence.end( ), [this, &keys](int left, int right) {
+            return getCount(keys.empty( ) ? left : keys[ left ]) < getCount(keys.empty( ) ? right : keys[ right ]);
+         });
+         return sequence;
+      }
+   };
+
+} // namespace bugger
+
+#endif
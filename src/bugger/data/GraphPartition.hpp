@@ -0,0 +1,139 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BUGGER_DATA_GRAPHPARTITION_HPP__
+#define __BUGGER_DATA_GRAPHPARTITION_HPP__
+
+#include "bugger/data/Problem.hpp"
+#include <deque>
+
+
+namespace bugger
+{
+   /**
+    * orders rows or columns along the graph of the active rows and columns
+    * every component is traversed breadth first from a pseudo-peripheral vertex, so that consecutive elements of the
+    * order are close in the graph and contiguous batches of equal size form a balanced partition into coherent regions,
+    * while inactive elements are appended in index order
+    */
+   template <typename REAL>
+   class GraphPartition
+   {
+   public:
+
+      /**
+       * @param problem
+       * @return order of all rows
+       */
+      static Vec<int>
+      getRowOrder(const Problem<REAL>& problem)
+      {
+         return getOrder(problem, true);
+      }
+
+      /**
+       * @param problem
+       * @return order of all columns
+       */
+      static Vec<int>
+      getColumnOrder(const Problem<REAL>& problem)
+      {
+         return getOrder(problem, false);
+      }
+
+   private:
+
+      static Vec<int>
+      getOrder(const Problem<REAL>& problem, bool rows)
+      {
+         const auto& matrix = problem.getConstraintMatrix( );
+         const auto& rflags = problem.getRowFlags( );
+         const auto& cflags = problem.getColFlags( );
+         const int nrows = problem.getNRows( );
+         const int ncols = problem.getNCols( );
+         // vertices 0 to nrows - 1 are rows and nrows to nrows + ncols - 1 are columns
+         auto active = [&](int vertex) {
+            return vertex < nrows ? !rflags[ vertex ].test(RowFlag::kRedundant)
+                                  : !cflags[ vertex - nrows ].test(ColFlag::kFixed);
+         };
+         auto neighbors = [&](int vertex) {
+            return vertex < nrows ? matrix.getRowCoefficients(vertex) : matrix.getColumnCoefficients(vertex - nrows);
+         };
+         const int offset = rows ? 0 : nrows;
+         const int nelements = rows ? nrows : ncols;
+         Vec<int> marks(nrows + ncols, -1);
+         Vec<int> order { };
+         order.reserve(nelements);
+         std::deque<int> queue { };
+
+         // traverses the component of start with mark and returns its last element
+         auto traverse = [&](int start, int mark, bool record) {
+            int last = start;
+            marks[ start ] = mark;
+            queue.push_back(start);
+            while( !queue.empty( ) )
+            {
+               int vertex = queue.front( );
+               queue.pop_front( );
+               if( ( vertex < nrows ) == rows )
+               {
+                  last = vertex;
+                  if( record )
+                     order.push_back(vertex - offset);
+               }
+               const auto& data = neighbors(vertex);
+               for( int index = 0; index < data.getLength( ); ++index )
+               {
+                  int neighbor = data.getIndices( )[ index ] + ( vertex < nrows ? nrows : 0 );
+                  if( marks[ neighbor ] != mark && active(neighbor) )
+                  {
+                     marks[ neighbor ] = mark;
+                     queue.push_back(neighbor);
+                  }
+               }
+            }
+            return last;
+         };
+
+         int nmarks = 0;
+         for( int element = 0; element < nelements; ++element )
+         {
+            int start = element + offset;
+            if( marks[ start ] >= 0 || !active(start) )
+               continue;
+            // restart from the farthest element to obtain a pseudo-peripheral vertex
+            start = traverse(start, nmarks++, false);
+            traverse(start, nmarks++, true);
+         }
+         for( int element = 0; element < nelements; ++element )
+            if( !active(element + offset) )
+               order.push_back(element);
+         assert((int)order.size( ) == nelements);
+         return order;
+      }
+   };
+
+} // namespace bugger
+
+#endif
@@ -0,0 +1,91 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BUGGER_DATA_MEMORYUSAGE_HPP__
+#define __BUGGER_DATA_MEMORYUSAGE_HPP__
+
+#include "bugger/data/Problem.hpp"
+#include "bugger/misc/Memory.hpp"
+
+
+namespace bugger
+{
+   /**
+    * bytes held by the data structures of a problem, the scratch arena of the calling thread, and the process
+    */
+   struct MemoryUsage
+   {
+      std::size_t rowmajor = 0;
+      std::size_t colmajor = 0;
+      std::size_t domains = 0;
+      std::size_t names = 0;
+      std::size_t scratch = 0;
+      std::size_t resident = 0;
+      std::size_t peak = 0;
+
+      /**
+       * measures the memory of the problem and the process
+       * @param problem
+       */
+      template <typename REAL>
+      static MemoryUsage
+      measure(const Problem<REAL>& problem)
+      {
+         MemoryUsage usage { };
+         usage.rowmajor = problem.getConstraintMatrix( ).getConstraintMatrix( ).getMemoryUsage( );
+         usage.colmajor = problem.getConstraintMatrix( ).getMatrixTranspose( ).getMemoryUsage( );
+         usage.domains = problem.getVariableDomains( ).getMemoryUsage( );
+         usage.names = get_memory_usage(problem.getVariableNames( )) + get_memory_usage(problem.getConstraintNames( ));
+         usage.scratch = Arena::local( ).getCapacity( );
+         usage.resident = get_resident_memory( );
+         usage.peak = std::max(get_peak_memory( ), usage.resident);
+         return usage;
+      }
+
+      /**
+       * keeps the maximum of every entry
+       * @param usage
+       */
+      void
+      merge(const MemoryUsage& usage)
+      {
+         rowmajor = std::max(rowmajor, usage.rowmajor);
+         colmajor = std::max(colmajor, usage.colmajor);
+         domains = std::max(domains, usage.domains);
+         names = std::max(names, usage.names);
+         scratch = std::max(scratch, usage.scratch);
+         resident = std::max(resident, usage.resident);
+         peak = std::max(peak, usage.peak);
+      }
+
+      static double
+      toMiB(std::size_t bytes)
+      {
+         return bytes / 1048576.0;
+      }
+   };
+
+} // namespace bugger
+
+#endif
@@ -0,0 +1,222 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BUGGER_DATA_PROBLEMDELTA_HPP__
+#define __BUGGER_DATA_PROBLEMDELTA_HPP__
+
+#include "bugger/data/Problem.hpp"
+#include <boost/optional.hpp>
+
+
+namespace bugger
+{
+   /// modified column of a problem
+   template <typename REAL>
+   struct ColumnChange
+   {
+      int col;
+      ColFlags flags;
+      REAL lower;
+      REAL upper;
+      REAL objective;
+
+      template <typename Archive>
+      void
+      serialize(Archive& ar, const unsigned int version)
+      {
+         ar& col;
+         ar& flags;
+         ar& lower;
+         ar& upper;
+         ar& objective;
+      }
+   };
+
+   /// modified row of a problem
+   template <typename REAL>
+   struct RowChange
+   {
+      int row;
+      RowFlags flags;
+      REAL lhs;
+      REAL rhs;
+
+      template <typename Archive>
+      void
+      serialize(Archive& ar, const unsigned int version)
+      {
+         ar& row;
+         ar& flags;
+         ar& lhs;
+         ar& rhs;
+      }
+   };
+
+   /// modified coefficient of a problem where value zero removes the entry
+   template <typename REAL>
+   struct CoefficientChange
+   {
+      int row;
+      int col;
+      REAL val;
+
+      template <typename Archive>
+      void
+      serialize(Archive& ar, const unsigned int version)
+      {
+         ar& row;
+         ar& col;
+         ar& val;
+      }
+   };
+
+   /**
+    * difference of a problem to a base problem
+    * only reductions are representable, this means the problem must have the dimensions of the base and the support of
+    * its matrix must be contained in the support of the base matrix, which holds for all modifications of the bugger
+    */
+   template <typename REAL>
+   class ProblemDelta
+   {
+   public:
+
+      Vec<ColumnChange<REAL>> columns { };
+      Vec<RowChange<REAL>> rows { };
+      Vec<CoefficientChange<REAL>> coefficients { };
+      REAL offset { };
+
+      bool
+      empty( ) const
+      {
+         return columns.empty( ) && rows.empty( ) && coefficients.empty( );
+      }
+
+      /**
+       * computes the difference of problem to base
+       * @param base
+       * @param problem
+       * @return difference or boost::none if the problem is not a reduction of the base
+       */
+      static boost::optional<ProblemDelta<REAL>>
+      compute(const Problem<REAL>& base, const Problem<REAL>& problem)
+      {
+         if( base.getNCols( ) != problem.getNCols( ) || base.getNRows( ) != problem.getNRows( ) )
+            return boost::none;
+
+         ProblemDelta<REAL> delta { };
+         const auto& base_matrix = base.getConstraintMatrix( );
+         const auto& matrix = problem.getConstraintMatrix( );
+         delta.offset = problem.getObjective( ).offset;
+
+         for( int col = 0; col < problem.getNCols( ); ++col )
+         {
+            if( base.getColFlags( )[ col ] != problem.getColFlags( )[ col ]
+             || base.getLowerBounds( )[ col ] != problem.getLowerBounds( )[ col ]
+             || base.getUpperBounds( )[ col ] != problem.getUpperBounds( )[ col ]
+             || base.getObjective( ).coefficients[ col ] != problem.getObjective( ).coefficients[ col ] )
+               delta.columns.push_back({ col, problem.getColFlags( )[ col ], problem.getLowerBounds( )[ col ],
+                                         problem.getUpperBounds( )[ col ], problem.getObjective( ).coefficients[ col ] });
+         }
+
+         for( int row = 0; row < problem.getNRows( ); ++row )
+         {
+            if( base.getRowFlags( )[ row ] != problem.getRowFlags( )[ row ]
+             || base_matrix.getLeftHandSides( )[ row ] != matrix.getLeftHandSides( )[ row ]
+             || base_matrix.getRightHandSides( )[ row ] != matrix.getRightHandSides( )[ row ] )
+               delta.rows.push_back({ row, problem.getRowFlags( )[ row ], matrix.getLeftHandSides( )[ row ],
+                                      matrix.getRightHandSides( )[ row ] });
+
+            const auto& base_data = base_matrix.getRowCoefficients(row);
+            const auto& data = matrix.getRowCoefficients(row);
+            int index = 0;
+            for( int base_index = 0; base_index < base_data.getLength( ); ++base_index )
+            {
+               int col = base_data.getIndices( )[ base_index ];
+               if( index < data.getLength( ) && data.getIndices( )[ index ] < col )
+                  return boost::none;
+               if( index < data.getLength( ) && data.getIndices( )[ index ] == col )
+               {
+                  if( data.getValues( )[ index ] != base_data.getValues( )[ base_index ] )
+                     delta.coefficients.push_back({ row, col, data.getValues( )[ index ] });
+                  ++index;
+               }
+               else
+                  delta.coefficients.push_back({ row, col, 0 });
+            }
+            if( index < data.getLength( ) )
+               return boost::none;
+         }
+
+         return delta;
+      }
+
+      /**
+       * applies the difference to the base it was computed for
+       * @param problem
+       */
+      void
+      apply(Problem<REAL>& problem) const
+      {
+         auto& matrix = problem.getConstraintMatrix( );
+         problem.getObjective( ).offset = offset;
+
+         for( const auto& change: columns )
+         {
+            problem.getColFlags( )[ change.col ] = change.flags;
+            problem.getLowerBounds( )[ change.col ] = change.lower;
+            problem.getUpperBounds( )[ change.col ] = change.upper;
+            problem.getObjective( ).coefficients[ change.col ] = change.objective;
+         }
+
+         for( const auto& change: rows )
+         {
+            problem.getRowFlags( )[ change.row ] = change.flags;
+            matrix.getLeftHandSides( )[ change.row ] = change.lhs;
+            matrix.getRightHandSides( )[ change.row ] = change.rhs;
+         }
+
+         if( !coefficients.empty( ) )
+         {
+            ScratchVec<Triplet<REAL>> triplets { };
+            triplets.reserve(coefficients.size( ));
+            for( const auto& change: coefficients )
+               triplets.emplace_back(change.row, change.col, change.val);
+            matrix.changeCoefficients(triplets);
+         }
+      }
+
+      template <typename Archive>
+      void
+      serialize(Archive& ar, const unsigned int version)
+      {
+         ar& columns;
+         ar& rows;
+         ar& coefficients;
+         ar& offset;
+      }
+   };
+
+} // namespace bugger
+
+#endif
@@ -0,0 +1,411 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BUGGER_DATA_REDUCTIONLOG_HPP__
+#define __BUGGER_DATA_REDUCTIONLOG_HPP__
+
+#include "bugger/data/ProblemDelta.hpp"
+#include "bugger/data/SolverSettings.hpp"
+#include "bugger/misc/fmt.hpp"
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+
+namespace bugger
+{
+   /**
+    * text log of the accepted reductions from which the reduced instance is replayed without solves
+    * every accepted batch is appended as the difference to its predecessor, where columns, rows, and settings are
+    * identified by index and values are written losslessly so that the log is independent of the arithmetic type
+    *   log <rows> <columns>
+    *   batch <number> <round> <modifier>
+    *   col <col> <flags> <lower> <upper> <objective>
+    *   row <row> <flags> <lhs> <rhs>
+    *   coef <row> <col> <value>
+    *   offset <value>
+    *   setting <bool|int|long|double|char|string|limit> <index> <value>
+    */
+   template <typename REAL>
+   class ReductionLog
+   {
+   private:
+
+      std::ofstream file { };
+      SolverSettings settings { };
+      long long nbatches = 0;
+      int round = -1;
+
+   public:
+
+      /**
+       * starts the log of the given instance
+       * @param filename
+       * @param problem
+       * @param _settings
+       * @return whether the file could be opened
+       */
+      bool
+      open(const String& filename, const Problem<REAL>& problem, const SolverSettings& _settings)
+      {
+         file.open(filename, std::ofstream::out | std::ofstream::trunc);
+         if( !file )
+            return false;
+         settings = _settings;
+         nbatches = 0;
+         fmt::print(file, "log {} {}\n", problem.getNRows( ), problem.getNCols( ));
+         file.flush( );
+         return true;
+      }
+
+      void
+      setRound(int value)
+      {
+         round = value;
+      }
+
+      long long
+      getNBatches( ) const
+      {
+         return nbatches;
+      }
+
+      /**
+       * appends the reductions of an accepted batch
+       * @param modifier name of the modifier
+       * @param base problem before the batch
+       * @param problem problem after the batch
+       * @param _settings settings after the batch
+       */
+      void
+      append(const String& modifier, const Problem<REAL>& base, const Problem<REAL>& problem, const SolverSettings& _settings)
+      {
+         auto delta = ProblemDelta<REAL>::compute(base, problem);
+         if( !delta )
+            throw std::runtime_error("reduction of modifier " + modifier + " not representable in log");
+         bool shifted = delta->offset != base.getObjective( ).offset;
+         if( delta->empty( ) && !shifted && !hasChanges(_settings) )
+            return;
+         writeHeader(modifier);
+         for( const auto& change: delta->columns )
+            fmt::print(file, "col {} {} {} {} {}\n", change.col, getBits<ColFlag>(change.flags), formatValue(change.lower),
+                       formatValue(change.upper), formatValue(change.objective));
+         for( const auto& change: delta->rows )
+            fmt::print(file, "row {} {} {} {}\n", change.row, getBits<RowFlag>(change.flags), formatValue(change.lhs),
+                       formatValue(change.rhs));
+         for( const auto& change: delta->coefficients )
+            fmt::print(file, "coef {} {} {}\n", change.row, change.col, formatValue(change.val));
+         if( shifted )
+            fmt::print(file, "offset {}\n", formatValue(delta->offset));
+         writeSettings(_settings);
+         file.flush( );
+      }
+
+      /**
+       * appends the changed settings as a batch without reductions of the problem
+       * @param modifier name of the modifier
+       * @param _settings
+       */
+      void
+      appendSettings(const String& modifier, const SolverSettings& _settings)
+      {
+         if( !hasChanges(_settings) )
+            return;
+         writeHeader(modifier);
+         writeSettings(_settings);
+         file.flush( );
+      }
+
+      /**
+       * applies the logged reductions to the instance the log was started with
+       * @param filename
+       * @param problem
+       * @param settings
+       * @param limit maximum number of batches to apply or -1 for all
+       * @return number of applied batches
+       */
+      static long long
+      replay(const String& filename, Problem<REAL>& problem, SolverSettings& settings, long long limit)
+      {
+         std::ifstream input(filename);
+         if( !input )
+            throw std::runtime_error("could not open reduction log " + filename);
+
+         long long nreplayed = 0;
+         bool pending = false;
+         ProblemDelta<REAL> delta { };
+         String line;
+         for( int number = 1; std::getline(input, line); ++number )
+         {
+            std::istringstream stream(line);
+            String type;
+            if( !( stream >> type ) )
+               continue;
+            try
+            {
+               if( type == "log" )
+               {
+                  int nrows;
+                  int ncols;
+                  stream >> nrows >> ncols;
+                  if( nrows != problem.getNRows( ) || ncols != problem.getNCols( ) )
+                     throw std::invalid_argument(fmt::format("logged for {} rows and {} columns instead of {} and {}",
+                                                             nrows, ncols, problem.getNRows( ), problem.getNCols( )));
+               }
+               else if( type == "batch" )
+               {
+                  if( pending )
+                  {
+                     delta.apply(problem);
+                     ++nreplayed;
+                  }
+                  if( limit >= 0 && nreplayed >= limit )
+                     return nreplayed;
+                  delta = ProblemDelta<REAL> { };
+                  delta.offset = problem.getObjective( ).offset;
+                  pending = true;
+               }
+               else if( !pending )
+                  throw std::invalid_argument("change " + type + " outside of batch");
+               else if( type == "col" )
+               {
+                  ColumnChange<REAL> change { };
+                  unsigned int flags;
+                  stream >> change.col >> flags;
+                  checkIndex(change.col, problem.getNCols( ));
+                  change.flags = ColFlags(static_cast<ColFlag>(flags));
+                  change.lower = readValue(stream);
+                  change.upper = readValue(stream);
+                  change.objective = readValue(stream);
+                  delta.columns.push_back(change);
+               }
+               else if( type == "row" )
+               {
+                  RowChange<REAL> change { };
+                  unsigned int flags;
+                  stream >> change.row >> flags;
+                  checkIndex(change.row, problem.getNRows( ));
+                  change.flags = RowFlags(static_cast<RowFlag>(flags));
+                  change.lhs = readValue(stream);
+                  change.rhs = readValue(stream);
+                  delta.rows.push_back(change);
+               }
+               else if( type == "coef" )
+               {
+                  CoefficientChange<REAL> change { };
+                  stream >> change.row >> change.col;
+                  checkIndex(change.row, problem.getNRows( ));
+                  checkIndex(change.col, problem.getNCols( ));
+                  change.val = readValue(stream);
+                  delta.coefficients.push_back(change);
+               }
+               else if( type == "offset" )
+                  delta.offset = readValue(stream);
+               else if( type == "setting" )
+                  readSetting(stream, settings);
+               else
+                  throw std::invalid_argument("unknown change " + type);
+               if( stream.fail( ) )
+                  throw std::invalid_argument("incomplete change " + type);
+            }
+            catch( const std::exception& exception )
+            {
+               throw std::runtime_error(fmt::format("invalid reduction log {} line {}: {}", filename, number, exception.what( )));
+            }
+         }
+         if( pending )
+         {
+            delta.apply(problem);
+            ++nreplayed;
+         }
+         return nreplayed;
+      }
+
+   private:
+
+      void
+      writeHeader(const String& modifier)
+      {
+         fmt::print(file, "batch {} {} {}\n", ++nbatches, round + 1, modifier);
+      }
+
+      template <typename FLAG, typename FLAGS>
+      static unsigned int
+      getBits(const FLAGS& flags)
+      {
+         unsigned int bits = 0;
+         for( unsigned int bit = 0; bit < 8 * sizeof(FLAG); ++bit )
+            if( flags.test(static_cast<FLAG>(1U << bit)) )
+               bits |= 1U << bit;
+         return bits;
+      }
+
+      static void
+      checkIndex(int index, int size)
+      {
+         if( index < 0 || index >= size )
+            throw std::out_of_range("index " + std::to_string(index) + " out of range");
+      }
+
+      /**
+       * formats a value such that reading it reproduces it, where doubles and double-doubles are written as shortest
+       * strings and other types with all the digits that distinguish them
+       */
+      static String
+      formatValue(double value)
+      {
+         return fmt::format("{}", value);
+      }
+
+      static String
+      formatValue(const DoubleDouble& value)
+      {
+         return value.toString( );
+      }
+
+      template <typename T>
+      static String
+      formatValue(const T& value)
+      {
+         std::ostringstream stream;
+         stream.precision(std::numeric_limits<T>::max_digits10);
+         stream << value;
+         return stream.str( );
+      }
+
+      static REAL
+      readValue(std::istringstream& stream)
+      {
+         String token;
+         stream >> token;
+         if( token == "inf" || token == "-inf" )
+            return REAL(token[ 0 ] == '-' ? -std::numeric_limits<double>::infinity( ) : std::numeric_limits<double>::infinity( ));
+         return parse_number<REAL>(token);
+      }
+
+      bool
+      hasChanges(const SolverSettings& current) const
+      {
+         return current.getBoolSettings( ) != settings.getBoolSettings( )
+             || current.getIntSettings( ) != settings.getIntSettings( )
+             || current.getLongSettings( ) != settings.getLongSettings( )
+             || current.getDoubleSettings( ) != settings.getDoubleSettings( )
+             || current.getCharSettings( ) != settings.getCharSettings( )
+             || current.getStringSettings( ) != settings.getStringSettings( )
+             || current.getLimitSettings( ) != settings.getLimitSettings( );
+      }
+
+      template <typename T, typename PRINT>
+      void
+      writeChanges(const char* type, const Vec<std::pair<String, T>>& currents, const Vec<std::pair<String, T>>& previous,
+                   PRINT&& print)
+      {
+         for( int i = 0; i < (int)currents.size( ); ++i )
+         {
+            if( i >= (int)previous.size( ) || currents[ i ].second != previous[ i ].second )
+            {
+               fmt::print(file, "setting {} {} ", type, i);
+               print(currents[ i ].second);
+               fmt::print(file, "\n");
+            }
+         }
+      }
+
+      void
+      writeSettings(const SolverSettings& current)
+      {
+         if( !hasChanges(current) )
+            return;
+         auto plain = [this](const auto& value) { fmt::print(file, "{}", value); };
+         writeChanges("bool", current.getBoolSettings( ), settings.getBoolSettings( ), [this](bool value) { fmt::print(file, "{}", (int)value); });
+         writeChanges("int", current.getIntSettings( ), settings.getIntSettings( ), plain);
+         writeChanges("long", current.getLongSettings( ), settings.getLongSettings( ), plain);
+         writeChanges("double", current.getDoubleSettings( ), settings.getDoubleSettings( ), plain);
+         writeChanges("char", current.getCharSettings( ), settings.getCharSettings( ), [this](char value) { fmt::print(file, "{}", (int)value); });
+         writeChanges("string", current.getStringSettings( ), settings.getStringSettings( ), plain);
+         writeChanges("limit", current.getLimitSettings( ), settings.getLimitSettings( ), plain);
+         settings = current;
+      }
+
+      static void
+      readSetting(std::istringstream& stream, SolverSettings& settings)
+      {
+         String type;
+         int index;
+         stream >> type >> index;
+         if( type == "bool" || type == "int" || type == "long" || type == "char" || type == "limit" )
+         {
+            long long value;
+            stream >> value;
+            if( type == "bool" )
+            {
+               checkIndex(index, settings.getBoolSettings( ).size( ));
+               settings.setBoolSettings(index, value != 0);
+            }
+            else if( type == "int" )
+            {
+               checkIndex(index, settings.getIntSettings( ).size( ));
+               settings.setIntSettings(index, (int)value);
+            }
+            else if( type == "long" )
+            {
+               checkIndex(index, settings.getLongSettings( ).size( ));
+               settings.setLongSettings(index, (long)value);
+            }
+            else if( type == "char" )
+            {
+               checkIndex(index, settings.getCharSettings( ).size( ));
+               settings.setCharSettings(index, (char)value);
+            }
+            else
+            {
+               checkIndex(index, settings.getLimitSettings( ).size( ));
+               settings.setLimitSettings(index, value);
+            }
+         }
+         else if( type == "double" )
+         {
+            String value;
+            stream >> value;
+            checkIndex(index, settings.getDoubleSettings( ).size( ));
+            settings.setDoubleSettings(index, std::stod(value));
+         }
+         else if( type == "string" )
+         {
+            String value;
+            stream.get( );
+            std::getline(stream, value);
+            stream.clear( );
+            checkIndex(index, settings.getStringSettings( ).size( ));
+            settings.setStringSettings(index, value);
+         }
+         else
+            throw std::invalid_argument("unknown setting type " + type);
+      }
+   };
+
+} // namespace bugger
+
+#endif
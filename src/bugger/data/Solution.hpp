@@ -50,6 +50,15 @@ namespace bugger
       Solution(const SolutionStatus& _status) : status(_status) { }
 
       Solution(const Vec<REAL>& _primal) : status(SolutionStatus::kFeasible), primal(_primal) { }
+
+      template <typename Archive>
+      void
+      serialize(Archive& ar, const unsigned int version)
+      {
+         ar& status;
+         ar& primal;
+         ar& ray;
+      }
    };
 
 } // namespace bugger
@@ -0,0 +1,223 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BUGGER_DATA_SOLVESCHEDULER_HPP__
+#define __BUGGER_DATA_SOLVESCHEDULER_HPP__
+
+#include "bugger/misc/Vec.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+
+namespace bugger
+{
+   /**
+    * fair share scheduler of the solve slots shared by concurrent bugger sessions
+    * a free slot is granted to the waiting client with the least accumulated solving time, where ties are broken by
+    * arrival, and clients enrolling later start from the least usage of the active clients so that they do not
+    * monopolize the slots to catch up
+    */
+   class SolveScheduler
+   {
+   public:
+
+      class Client
+      {
+      private:
+
+         SolveScheduler& scheduler;
+         const int index;
+         double time = 0.0;
+
+      public:
+
+         Client(SolveScheduler& _scheduler, int _index) : scheduler(_scheduler), index(_index) { }
+
+         Client(const Client&) = delete;
+
+         Client&
+         operator=(const Client&) = delete;
+
+         ~Client( )
+         {
+            scheduler.leave(index);
+         }
+
+         /**
+          * blocks until a slot is granted to this client
+          */
+         void
+         acquire( )
+         {
+            scheduler.acquire(index);
+         }
+
+         /**
+          * returns the slot and accounts its usage
+          * @param seconds time the slot was occupied
+          */
+         void
+         release(double seconds)
+         {
+            time += seconds;
+            scheduler.release(index, seconds);
+         }
+
+         /**
+          * @return time the slots of this client were occupied
+          */
+         double
+         getTime( ) const
+         {
+            return time;
+         }
+      };
+
+      /**
+       * occupies a slot of the client for the lifetime of the object, does nothing without client
+       */
+      class Slot
+      {
+      private:
+
+         Client* const client;
+         std::chrono::steady_clock::time_point start { };
+
+      public:
+
+         explicit Slot(const std::shared_ptr<Client>& _client) : client(_client.get( ))
+         {
+            if( client != nullptr )
+               client->acquire( );
+            start = std::chrono::steady_clock::now( );
+         }
+
+         Slot(const Slot&) = delete;
+
+         Slot&
+         operator=(const Slot&) = delete;
+
+         ~Slot( )
+         {
+            if( client != nullptr )
+               client->release(std::chrono::duration<double>(std::chrono::steady_clock::now( ) - start).count( ));
+         }
+      };
+
+   private:
+
+      struct Waiter
+      {
+         int index;
+         long long ticket;
+      };
+
+      std::mutex mutex { };
+      std::condition_variable condition { };
+      const int nslots;
+      int nbusy = 0;
+      long long ntickets = 0;
+      Vec<double> usages { };
+      Vec<bool> actives { };
+      Vec<Waiter> waiters { };
+
+   public:
+
+      explicit SolveScheduler(int _nslots) : nslots(std::max(_nslots, 1)) { }
+
+      SolveScheduler(const SolveScheduler&) = delete;
+
+      SolveScheduler&
+      operator=(const SolveScheduler&) = delete;
+
+      /**
+       * registers a new client, which has to be released before the scheduler
+       * @return client
+       */
+      std::shared_ptr<Client>
+      enroll( )
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         double usage = -1.0;
+         for( int index = 0; index < (int)usages.size( ); ++index )
+            if( actives[ index ] && ( usage < 0.0 || usages[ index ] < usage ) )
+               usage = usages[ index ];
+         usages.push_back(std::max(usage, 0.0));
+         actives.push_back(true);
+         return std::make_shared<Client>(*this, (int)usages.size( ) - 1);
+      }
+
+      int
+      getNSlots( ) const
+      {
+         return nslots;
+      }
+
+   private:
+
+      void
+      leave(int index)
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         actives[ index ] = false;
+      }
+
+      void
+      acquire(int index)
+      {
+         std::unique_lock<std::mutex> lock(mutex);
+         const long long ticket = ntickets++;
+         waiters.push_back({ index, ticket });
+         condition.wait(lock, [this, ticket]( ) {
+            if( nbusy >= nslots )
+               return false;
+            auto preferred = std::min_element(waiters.begin( ), waiters.end( ), [this](const Waiter& left, const Waiter& right) {
+               return usages[ left.index ] < usages[ right.index ]
+                   || ( usages[ left.index ] == usages[ right.index ] && left.ticket < right.ticket );
+            });
+            return preferred->ticket == ticket;
+         });
+         waiters.erase(std::find_if(waiters.begin( ), waiters.end( ), [ticket](const Waiter& waiter) {
+            return waiter.ticket == ticket;
+         }));
+         ++nbusy;
+         condition.notify_all( );
+      }
+
+      void
+      release(int index, double seconds)
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         usages[ index ] += seconds;
+         --nbusy;
+         condition.notify_all( );
+      }
+   };
+
+} // namespace bugger
+
+#endif
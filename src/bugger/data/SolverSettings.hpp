@@ -125,6 +125,17 @@ namespace bugger {
       void setLimitSettings(int index, long long value) {
          limit_settings[ index ].second = value;
       }
+
+      template <typename Archive>
+      void serialize(Archive& ar, const unsigned int version) {
+         ar& bool_settings;
+         ar& int_settings;
+         ar& long_settings;
+         ar& double_settings;
+         ar& char_settings;
+         ar& string_settings;
+         ar& limit_settings;
+      }
    };
 
 } // namespace bugger
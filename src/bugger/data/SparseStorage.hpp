@@ -25,13 +25,20 @@
 #ifndef _BUGGER_CORE_SPARSE_STORAGE_HPP_
 #define _BUGGER_CORE_SPARSE_STORAGE_HPP_
 
+#include "bugger/misc/Memory.hpp"
 #include "bugger/misc/Vec.hpp"
 #include "bugger/misc/Num.hpp"
 #include "bugger/external/pdqsort/pdqsort.h"
+#ifdef BUGGER_TBB
+#include "bugger/misc/tbb.hpp"
+#endif
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <cstring>
+#include <functional>
+#include <memory>
 #include <tuple>
 
 namespace bugger
@@ -126,6 +133,14 @@ class SparseStorage
       return nAlloc;
    }
 
+   /// bytes held by the buffers of the storage
+   std::size_t
+   getMemoryUsage() const
+   {
+      return get_memory_usage( values ) + get_memory_usage( columns ) +
+             get_memory_usage( rowranges );
+   }
+
    const REAL*
    getValues() const
    {
@@ -183,6 +198,92 @@ class SparseStorage
    Vec<int>
    getRowStarts() const;
 
+   // function to change existing coefficients in several rows. Must not be
+   // called with coefficients that are currently not in the rows. The changes
+   // are the positions in order, which are sorted by row and column, and a row
+   // starts at each position in starts, while the last entry of starts ends the
+   // changes. The GetRow, GetCol, and GetVal callbacks retrieve the parts of the
+   // change at a position, where the last change of a coefficient counts, and
+   // the RowChanged callback receives the new size of each changed row. Rows
+   // are processed in parallel if TBB is enabled.
+   template <typename GetRow, typename GetCol, typename GetVal,
+             typename RowChanged>
+   void
+   changeRowsInplace( const ScratchVec<int>& order,
+                      const ScratchVec<int>& starts, GetRow&& getRow,
+                      GetCol&& getCol, GetVal&& getVal,
+                      RowChanged&& rowChanged )
+   {
+      auto mergeRow = [&]( int group ) {
+         int k = starts[group];
+         int kend = starts[group + 1];
+         int row = getRow( order[k] );
+         int i = rowranges[row].start;
+         int j = 0;
+
+         while( k != kend )
+         {
+            int col = getCol( order[k] );
+            while( k + 1 != kend && getCol( order[k + 1] ) == col )
+               ++k;
+            const REAL& newval = getVal( order[k] );
+            ++k;
+
+            while( col != columns[i] )
+            {
+               assert( i < rowranges[row].end );
+               if( j != 0 )
+               {
+                  columns[i - j] = columns[i];
+                  values[i - j] = std::move( values[i] );
+               }
+               ++i;
+            }
+
+            if( newval == 0 )
+               ++j;
+            else
+            {
+               columns[i - j] = columns[i];
+               values[i - j] = newval;
+            }
+
+            ++i;
+         }
+
+         if( j != 0 )
+         {
+            while( i != rowranges[row].end )
+            {
+               columns[i - j] = columns[i];
+               values[i - j] = std::move( values[i] );
+               ++i;
+            }
+
+            rowranges[row].end -= j;
+         }
+
+         rowChanged( row, rowranges[row].end - rowranges[row].start );
+         return j;
+      };
+
+      int ngroups = static_cast<int>( starts.size() ) - 1;
+#ifdef BUGGER_TBB
+      tbb::combinable<int> removed( []() { return 0; } );
+      tbb::parallel_for( tbb::blocked_range<int>( 0, ngroups ),
+                         [&]( const tbb::blocked_range<int>& r ) {
+                            int& local = removed.local();
+                            for( int group = r.begin(); group != r.end();
+                                 ++group )
+                               local += mergeRow( group );
+                         } );
+      nnz -= removed.combine( std::plus<int>() );
+#else
+      for( int group = 0; group < ngroups; ++group )
+         nnz -= mergeRow( group );
+#endif
+   }
+
    // function to change existing coefficients in row. Must not be called with
    // coefficients that are currently not in the row. Changes must be given in
    // sorted order.
@@ -400,6 +501,34 @@ class SparseStorage
       return static_cast<int>( nnz * spareRatio ) + nRows * minInterRowSpace;
    }
 
+#ifdef BUGGER_TBB
+   /// sorts the entries of the row by column
+   void
+   sortRow( int row )
+   {
+      const int start = rowranges[row].start;
+      const int end = rowranges[row].end;
+      if( std::is_sorted( columns.begin() + start, columns.begin() + end ) )
+         return;
+      Vec<int> order( end - start );
+      for( int k = 0; k < end - start; ++k )
+         order[k] = start + k;
+      pdqsort( order.begin(), order.end(),
+               [&]( int a, int b ) { return columns[a] < columns[b]; } );
+      Vec<int> sorted_columns( end - start );
+      Vec<REAL> sorted_values( end - start );
+      for( int k = 0; k < end - start; ++k )
+      {
+         sorted_columns[k] = columns[order[k]];
+         sorted_values[k] = std::move( values[order[k]] );
+      }
+      std::move( sorted_columns.begin(), sorted_columns.end(),
+                 columns.begin() + start );
+      std::move( sorted_values.begin(), sorted_values.end(),
+                 values.begin() + start );
+   }
+#endif
+
    Vec<REAL> values;
    Vec<IndexRange> rowranges;
    Vec<int> columns;
@@ -423,7 +552,11 @@ SparseStorage<REAL>::SparseStorage( Vec<Triplet<REAL>> entries, int nRows_in,
    assert( !sorted || std::is_sorted( entries.begin(), entries.end() ) );
 
    if( !sorted )
+#ifdef BUGGER_TBB
+      tbb::parallel_sort( entries.begin(), entries.end() );
+#else
       pdqsort( entries.begin(), entries.end() );
+#endif
 
    nnz = entries.size();
    nAlloc = computeNAlloc();
@@ -432,6 +565,81 @@ SparseStorage<REAL>::SparseStorage( Vec<Triplet<REAL>> entries, int nRows_in,
    values.resize( nAlloc );
    columns.resize( nAlloc );
 
+#ifdef BUGGER_TBB
+   // locate the entries of each row and count its nonzeros, where the first
+   // row and every row with entries receive spare space as in the sequential
+   // construction while other empty rows do not
+   Vec<int> first( nRows + 1 );
+   Vec<int> rowalloc( nRows );
+   first[nRows] = static_cast<int>( entries.size() );
+   tbb::parallel_for(
+       tbb::blocked_range<int>( 0, nRows ),
+       [&]( const tbb::blocked_range<int>& r ) {
+          for( int row = r.begin(); row != r.end(); ++row )
+             first[row] = static_cast<int>(
+                 std::lower_bound( entries.begin(), entries.end(), row,
+                                   []( const Triplet<REAL>& entry, int key ) {
+                                      return std::get<0>( entry ) < key;
+                                   } ) -
+                 entries.begin() );
+       } );
+   tbb::combinable<int> zeros( []() { return 0; } );
+   tbb::parallel_for( tbb::blocked_range<int>( 0, nRows ),
+                      [&]( const tbb::blocked_range<int>& r ) {
+                         int& local = zeros.local();
+                         for( int row = r.begin(); row != r.end(); ++row )
+                         {
+                            int size = 0;
+                            for( int k = first[row]; k != first[row + 1]; ++k )
+                               if( std::get<2>( entries[k] ) != 0 )
+                                  ++size;
+                            local += first[row + 1] - first[row] - size;
+                            rowranges[row].end = size;
+                            rowalloc[row] = row == 0 || first[row] != first[row + 1]
+                                                ? computeRowAlloc( size )
+                                                : 0;
+                         }
+                      } );
+   nnz -= zeros.combine( std::plus<int>() );
+
+   int total = tbb::parallel_scan(
+       tbb::blocked_range<int>( 0, nRows ), 0,
+       [&]( const tbb::blocked_range<int>& r, int sum, bool final ) {
+          for( int row = r.begin(); row != r.end(); ++row )
+          {
+             if( final )
+             {
+                rowranges[row].start = sum;
+                rowranges[row].end += sum;
+             }
+             sum += rowalloc[row];
+          }
+          return sum;
+       },
+       std::plus<int>() );
+   assert( total <= nAlloc );
+   rowranges[nRows].start = total;
+   rowranges[nRows].end = total;
+
+   tbb::parallel_for( tbb::blocked_range<int>( 0, nRows ),
+                      [&]( const tbb::blocked_range<int>& r ) {
+                         for( int row = r.begin(); row != r.end(); ++row )
+                         {
+                            int idx = rowranges[row].start;
+                            for( int k = first[row]; k != first[row + 1]; ++k )
+                            {
+                               assert( std::get<1>( entries[k] ) >= 0 &&
+                                       std::get<1>( entries[k] ) < nCols );
+                               if( std::get<2>( entries[k] ) != 0 )
+                               {
+                                  values[idx] = std::get<2>( entries[k] );
+                                  columns[idx++] = std::get<1>( entries[k] );
+                               }
+                            }
+                            assert( idx == rowranges[row].end );
+                         }
+                      } );
+#else
    rowranges[0].start = 0;
 
    int idx = 0;
@@ -499,6 +707,7 @@ SparseStorage<REAL>::SparseStorage( Vec<Triplet<REAL>> entries, int nRows_in,
    }
 
    rowranges[nRows].end = idx;
+#endif
 }
 
 template <typename REAL>
@@ -525,6 +734,72 @@ SparseStorage<REAL>::getTranspose() const
 //   if( nCols <= 0 )
 //      return SparseStorage<REAL>{};
 
+#ifdef BUGGER_TBB
+   // count the entries of each column, place the rows by a prefix sum over
+   // the column allocations, scatter the entries to their columns, and sort
+   // the rows within each column since the scatter does not keep their order
+   std::unique_ptr<std::atomic<int>[]> w( new std::atomic<int>[nCols]() );
+
+   tbb::parallel_for( tbb::blocked_range<int>( 0, nRows ),
+                      [&]( const tbb::blocked_range<int>& r ) {
+                         for( int row = r.begin(); row != r.end(); ++row )
+                            for( int j = rowranges[row].start;
+                                 j != rowranges[row].end; ++j )
+                            {
+                               assert( values[j] != REAL{ 0.0 } );
+                               w[columns[j]].fetch_add(
+                                   1, std::memory_order_relaxed );
+                            }
+                      } );
+
+   assert( spareRatio >= 1.0 );
+
+   SparseStorage<REAL> transpose{ nCols, nRows, nnz, spareRatio,
+                                  minInterRowSpace };
+
+   tbb::parallel_scan(
+       tbb::blocked_range<int>( 0, nCols ), 0,
+       [&]( const tbb::blocked_range<int>& r, int sum, bool final ) {
+          for( int col = r.begin(); col != r.end(); ++col )
+          {
+             const int size = w[col].load( std::memory_order_relaxed );
+             if( final )
+             {
+                transpose.rowranges[col].start = sum;
+                transpose.rowranges[col].end = sum + size;
+                w[col].store( sum, std::memory_order_relaxed );
+             }
+             sum += transpose.computeRowAlloc( size );
+          }
+          return sum;
+       },
+       std::plus<int>() );
+
+   transpose.rowranges[nCols].start = transpose.nAlloc;
+   transpose.rowranges[nCols].end = transpose.nAlloc;
+
+   tbb::parallel_for( tbb::blocked_range<int>( 0, nRows ),
+                      [&]( const tbb::blocked_range<int>& r ) {
+                         for( int row = r.begin(); row != r.end(); ++row )
+                            for( int j = rowranges[row].start;
+                                 j != rowranges[row].end; ++j )
+                            {
+                               const int idx = w[columns[j]].fetch_add(
+                                   1, std::memory_order_relaxed );
+
+                               assert( idx < transpose.nAlloc );
+
+                               transpose.values[idx] = values[j];
+                               transpose.columns[idx] = row;
+                            }
+                      } );
+
+   tbb::parallel_for( tbb::blocked_range<int>( 0, nCols ),
+                      [&]( const tbb::blocked_range<int>& r ) {
+                         for( int col = r.begin(); col != r.end(); ++col )
+                            transpose.sortRow( col );
+                      } );
+#else
    // compute nnz of each row of At (column of A)
 
    Vec<int> w( size_t( nCols ), 0 );
@@ -583,6 +858,7 @@ SparseStorage<REAL>::getTranspose() const
          w[columns[j]] = idx + 1;
       }
    }
+#endif
    return transpose;
 }
 
@@ -614,6 +890,79 @@ SparseStorage<REAL>::compress( const Vec<int>& rowsize, const Vec<int>& colsize,
       nCols = colcount;
    }
 
+#ifdef BUGGER_TBB
+   // a full compression releases memory under pressure so that it moves the
+   // entries in place instead of allocating new buffers
+   if( nRows > 0 && !full )
+   {
+      // the rows keep the positions of the in-place compression, which are
+      // determined sequentially, while the entries are copied in parallel into
+      // new buffers with mapped columns
+      Vec<int> rowmap( nRows );
+      Vec<IndexRange> newranges;
+      newranges.reserve( nRows + 1 );
+      int offset = 0;
+      for( int r = 0; r < nRows; r++ )
+      {
+         const int start = rowranges[r].start;
+         const int end = rowranges[r].end;
+         const int rowalloc = rowranges[r + 1].start - start;
+
+         // empty row?
+         if( rowsize[r] == -1 )
+         {
+            rowmap[r] = -1;
+            offset += rowalloc;
+         }
+         else
+         {
+            assert( start >= offset );
+            rowmap[r] = static_cast<int>( newranges.size() );
+            newranges.emplace_back();
+            newranges.back().start = start - offset;
+            newranges.back().end = end - offset;
+            offset = max( offset + rowalloc - computeRowAlloc( end - start ), 0 );
+         }
+
+         assert( offset <= nAlloc );
+      }
+
+      newranges.emplace_back();
+      newranges.back().start = rowranges[nRows].start - offset;
+      newranges.back().end = rowranges[nRows].end - offset;
+      nAlloc = nAlloc - offset;
+      assert( nAlloc >= 0 );
+
+      Vec<REAL> newvalues( nAlloc );
+      Vec<int> newcolumns( nAlloc );
+      tbb::parallel_for(
+          tbb::blocked_range<int>( 0, nRows ),
+          [&]( const tbb::blocked_range<int>& range ) {
+             for( int r = range.begin(); r != range.end(); ++r )
+             {
+                if( rowmap[r] == -1 )
+                   continue;
+                int idx = newranges[rowmap[r]].start;
+                for( int j = rowranges[r].start; j != rowranges[r].end; ++j )
+                {
+                   assert( columns[j] >= 0 );
+                   assert( columns[j] < static_cast<int>( colsmap.size() ) );
+                   newvalues[idx] = std::move( values[j] );
+                   newcolumns[idx] = colsmap[columns[j]];
+                   assert( newcolumns[idx] >= 0 );
+                   assert( newcolumns[idx] < nCols );
+                   ++idx;
+                }
+             }
+          } );
+
+      nRows = static_cast<int>( newranges.size() ) - 1;
+      rowranges.swap( newranges );
+      values.swap( newvalues );
+      columns.swap( newcolumns );
+   }
+   else
+#endif
    if( nRows > 0 )
    {
       int offset = 0;
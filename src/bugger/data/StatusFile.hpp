@@ -0,0 +1,238 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BUGGER_DATA_STATUSFILE_HPP__
+#define __BUGGER_DATA_STATUSFILE_HPP__
+
+#include "bugger/modifiers/BuggerModifier.hpp"
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <fstream>
+
+
+namespace bugger
+{
+   /**
+    * status file of a bugger run in JSON format for polling by orchestration
+    * the file is written to a temporary sibling and renamed over the previous version so that readers never see a
+    * partial status, and updates within a modifier are throttled to one per second
+    */
+   template <typename REAL>
+   class StatusFile
+   {
+   private:
+
+      using Clock = std::chrono::steady_clock;
+
+      static constexpr double INTERVAL = 1.0;
+
+      const BuggerParameters& parameters;
+      const Vec<std::unique_ptr<BuggerModifier<REAL>>>& modifiers;
+      String filename;
+      Clock::time_point start { Clock::now( ) };
+      Clock::time_point last_write { };
+      Clock::time_point last_success { start };
+      Clock::time_point round_start { start };
+      double round_time = 0.0;
+      int nrounds = 0;
+      int round = -1;
+      int stage = -1;
+      int modifier = -1;
+      long long naccepted = 0;
+      int original_rows = 0;
+      int original_cols = 0;
+      long long original_nnz = 0;
+
+   public:
+
+      StatusFile(const BuggerParameters& _parameters, const Vec<std::unique_ptr<BuggerModifier<REAL>>>& _modifiers,
+                 const String& _filename) : parameters(_parameters), modifiers(_modifiers), filename(_filename) { }
+
+      /**
+       * records the dimensions of the original problem
+       * @param problem
+       */
+      void
+      setOriginal(const Problem<REAL>& problem)
+      {
+         countActive(problem, original_rows, original_cols, original_nnz);
+      }
+
+      /**
+       * starts a round and writes the status
+       * @param problem
+       * @param _round
+       * @param _stage
+       */
+      void
+      startRound(const Problem<REAL>& problem, int _round, int _stage)
+      {
+         auto now = Clock::now( );
+         if( round >= 0 )
+         {
+            round_time += std::chrono::duration<double>(now - round_start).count( );
+            ++nrounds;
+         }
+         round_start = now;
+         round = _round;
+         stage = _stage;
+         modifier = -1;
+         write(problem, "running");
+      }
+
+      /**
+       * starts a modifier and writes the status
+       * @param problem
+       * @param _modifier index of the modifier
+       */
+      void
+      startModifier(const Problem<REAL>& problem, int _modifier)
+      {
+         modifier = _modifier;
+         write(problem, "running");
+      }
+
+      /**
+       * writes the status after a batch if the last update is at least a second ago
+       * @param problem current problem
+       */
+      void
+      update(const Problem<REAL>& problem)
+      {
+         if( std::chrono::duration<double>(Clock::now( ) - last_write).count( ) >= INTERVAL )
+            write(problem, "running");
+      }
+
+      /**
+       * writes the final status
+       * @param problem
+       */
+      void
+      finish(const Problem<REAL>& problem)
+      {
+         modifier = -1;
+         write(problem, "finished");
+      }
+
+   private:
+
+      static void
+      countActive(const Problem<REAL>& problem, int& nrows, int& ncols, long long& nnz)
+      {
+         const auto& matrix = problem.getConstraintMatrix( );
+         nrows = 0;
+         ncols = 0;
+         nnz = 0;
+         for( int row = 0; row < problem.getNRows( ); ++row )
+         {
+            if( problem.getRowFlags( )[ row ].test(RowFlag::kRedundant) )
+               continue;
+            ++nrows;
+            nnz += matrix.getRowCoefficients(row).getLength( );
+         }
+         for( int col = 0; col < problem.getNCols( ); ++col )
+            if( !problem.getColFlags( )[ col ].test(ColFlag::kFixed) )
+               ++ncols;
+      }
+
+      void
+      write(const Problem<REAL>& problem, const char* state)
+      {
+         auto now = Clock::now( );
+         last_write = now;
+         double elapsed = std::chrono::duration<double>(now - start).count( );
+
+         long long nsolves = 0;
+         long long accepted = 0;
+         for( const auto& entry : modifiers )
+         {
+            nsolves += entry->getNSolves( );
+            accepted += entry->getNAcceptedBatches( );
+         }
+         if( accepted != naccepted )
+         {
+            naccepted = accepted;
+            last_success = now;
+         }
+
+         // every stage has to pass without success before the run ends, which takes at least one round per stage
+         double remaining = -1.0;
+         if( std::string(state) == "finished" )
+            remaining = 0.0;
+         else if( nrounds >= 1 )
+            remaining = std::max(round_time / nrounds * std::max(parameters.maxstages - stage, 1)
+                                 - std::chrono::duration<double>(now - round_start).count( ), 0.0);
+         if( parameters.tlim < std::numeric_limits<double>::max( ) )
+            remaining = remaining < 0.0 ? std::max(parameters.tlim - elapsed, 0.0)
+                                        : std::min(remaining, std::max(parameters.tlim - elapsed, 0.0));
+
+         int nrows;
+         int ncols;
+         long long nnz;
+         countActive(problem, nrows, ncols, nnz);
+
+         fmt::memory_buffer buffer;
+         auto out = std::back_inserter(buffer);
+         fmt::format_to(out, "{{\n");
+         fmt::format_to(out, "  \"state\": \"{}\",\n", state);
+         fmt::format_to(out, "  \"round\": {},\n", round + 1);
+         fmt::format_to(out, "  \"stage\": {},\n", stage + 1);
+         fmt::format_to(out, "  \"modifier\": {},\n", modifier >= 0 ? "\"" + modifiers[ modifier ]->getName( ) + "\"" : String("null"));
+         fmt::format_to(out, "  \"rows\": {},\n  \"original_rows\": {},\n", nrows, original_rows);
+         fmt::format_to(out, "  \"cols\": {},\n  \"original_cols\": {},\n", ncols, original_cols);
+         fmt::format_to(out, "  \"nnz\": {},\n  \"original_nnz\": {},\n", nnz, original_nnz);
+         fmt::format_to(out, "  \"solves\": {},\n", nsolves);
+         fmt::format_to(out, "  \"solves_per_minute\": {:.3f},\n", elapsed > 0.0 ? 60.0 * nsolves / elapsed : 0.0);
+         fmt::format_to(out, "  \"elapsed\": {:.3f},\n", elapsed);
+         fmt::format_to(out, "  \"since_success\": {:.3f},\n", std::chrono::duration<double>(now - last_success).count( ));
+         if( remaining >= 0.0 )
+            fmt::format_to(out, "  \"remaining\": {:.3f},\n", remaining);
+         else
+            fmt::format_to(out, "  \"remaining\": null,\n");
+         fmt::format_to(out, "  \"modifiers\": [");
+         for( int index = 0; index < (int)modifiers.size( ); ++index )
+         {
+            const auto& entry = modifiers[ index ];
+            long long evaluated = entry->getNEvaluatedBatches( );
+            fmt::format_to(out, "{}\n    {{ \"name\": \"{}\", \"enabled\": {}, \"batches\": {}, \"accepted\": {}, \"acceptance\": {:.4f} }}",
+                           index == 0 ? "" : ",", entry->getName( ), entry->isEnabled( ) ? "true" : "false", evaluated,
+                           entry->getNAcceptedBatches( ), evaluated >= 1 ? (double)entry->getNAcceptedBatches( ) / evaluated : 0.0);
+         }
+         fmt::format_to(out, "\n  ]\n}}\n");
+
+         String temporary = filename + ".tmp";
+         {
+            std::ofstream file(temporary, std::ofstream::out | std::ofstream::trunc);
+            file.write(buffer.data( ), buffer.size( ));
+            if( !file )
+               return;
+         }
+         boost::system::error_code error { };
+         boost::filesystem::rename(temporary, filename, error);
+      }
+   };
+
+} // namespace bugger
+
+#endif
@@ -26,6 +26,7 @@
 #define _BUGGER_CORE_VARIABLE_DOMAINS_HPP_
 
 #include "bugger/misc/Flags.hpp"
+#include "bugger/misc/Memory.hpp"
 #include "bugger/misc/MultiPrecision.hpp"
 #include "bugger/misc/Vec.hpp"
 #include "bugger/misc/compress_vector.hpp"
@@ -72,6 +73,14 @@ struct VariableDomains
    void
    compress( const Vec<int>& colmapping, bool full = false );
 
+   /// bytes held by the buffers of the domains
+   std::size_t
+   getMemoryUsage() const
+   {
+      return get_memory_usage( lower_bounds ) +
+             get_memory_usage( upper_bounds ) + get_memory_usage( flags );
+   }
+
    bool
    isBinary( int col ) const
    {
@@ -0,0 +1,326 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BUGGER_DATA_WORKERPOOL_HPP__
+#define __BUGGER_DATA_WORKERPOOL_HPP__
+
+#include "bugger/data/BuggerParameters.hpp"
+#include "bugger/io/Message.hpp"
+#include "bugger/io/WorkerProtocol.hpp"
+#include "bugger/misc/Trace.hpp"
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
+
+namespace bugger
+{
+   /**
+    * pool of remote solve workers
+    * jobs are queued centrally and pulled by the connection threads as soon as their worker is idle, so that fast
+    * workers take over the load of slow ones, jobs of lost workers are requeued, and a worker is declared lost if it
+    * neither answers nor sends heartbeats within the timeout
+    */
+   template <typename REAL>
+   class WorkerPool
+   {
+   public:
+
+      struct Task
+      {
+         WorkerJob<REAL> job { };
+         std::shared_ptr<const String> base { };
+         std::promise<WorkerResult> promise { };
+         std::future<WorkerResult> future { };
+         bool cancelled = false;
+      };
+
+   private:
+
+      struct Worker
+      {
+         String address { };
+         WorkerChannel channel { };
+         std::thread thread { };
+         long long base = -1;
+      };
+
+      const Message& msg;
+      const BuggerParameters& parameters;
+      Vec<std::unique_ptr<Worker>> workers { };
+      std::mutex mutex { };
+      std::condition_variable condition { };
+      std::deque<std::shared_ptr<Task>> queue { };
+      int nalive = 0;
+      bool finished = false;
+      long long njobs = 0;
+      long long nrequeued = 0;
+      long long nbases = 0;
+      std::unique_ptr<Problem<REAL>> base { };
+      Solution<REAL> solution { };
+      std::shared_ptr<const String> payload { };
+
+   public:
+
+      WorkerPool(const Message& _msg, const BuggerParameters& _parameters) : msg(_msg), parameters(_parameters) { }
+
+      WorkerPool(const WorkerPool&) = delete;
+
+      WorkerPool&
+      operator=(const WorkerPool&) = delete;
+
+      ~WorkerPool( )
+      {
+         stop( );
+      }
+
+      /**
+       * connects to the workers listed in the parameters
+       * @return number of connected workers
+       */
+      int
+      start( )
+      {
+         std::istringstream addresses(parameters.workers);
+         for( String address; addresses >> address; )
+         {
+            std::unique_ptr<Worker> worker { new Worker( ) };
+            worker->address = address;
+            if( !worker->channel.connect(address, parameters.worker_timeout) )
+            {
+               msg.warn("Worker {} is not reachable.\n", address);
+               continue;
+            }
+            WorkerHello hello { WorkerHello::get_signature<REAL>( ), parameters.worker_heartbeat };
+            WorkerMessage type { };
+            String answer { };
+            if( !worker->channel.send(WorkerMessage::kHello, WorkerChannel::pack(hello), parameters.worker_timeout)
+             || !worker->channel.receive(type, answer, parameters.worker_timeout) || type != WorkerMessage::kHello
+             || !WorkerChannel::unpack(answer, hello) || hello.signature != WorkerHello::get_signature<REAL>( ) )
+            {
+               msg.warn("Worker {} is not compatible.\n", address);
+               continue;
+            }
+            workers.push_back(std::move(worker));
+         }
+         nalive = workers.size( );
+         for( const auto& worker: workers )
+         {
+            Worker* const pointer = worker.get( );
+            worker->thread = std::thread([this, pointer, session = BUGGER_TRACE_CURRENT( )]( ) {
+               BUGGER_TRACE_JOIN(session);
+               serve(*pointer);
+            });
+         }
+         msg.info("Connected to {} of the workers.\n", nalive);
+         return nalive;
+      }
+
+      /**
+       * @return number of workers still alive
+       */
+      int
+      getNWorkers( )
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         return nalive;
+      }
+
+      long long
+      getNRequeued( )
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         return nrequeued;
+      }
+
+      /**
+       * sets base problem for subsequent jobs, which is transferred to each worker once
+       * @param problem
+       * @param reference
+       */
+      void
+      setBase(const Problem<REAL>& problem, const Solution<REAL>& reference)
+      {
+         WorkerBase<REAL> data { nbases++, problem, reference };
+         std::shared_ptr<const String> packed { new String(WorkerChannel::pack(data)) };
+         base.reset(new Problem<REAL>(std::move(data.problem)));
+         solution = std::move(data.solution);
+         std::lock_guard<std::mutex> lock(mutex);
+         payload = packed;
+      }
+
+      /**
+       * queues solve of the given problem as difference to the base
+       * @param settings
+       * @param problem
+       * @return task to be waited for or nullptr if no worker is alive
+       */
+      std::shared_ptr<Task>
+      submit(const SolverSettings& settings, const Problem<REAL>& problem)
+      {
+         if( getNWorkers( ) == 0 )
+            return nullptr;
+         assert(base);
+         auto delta = ProblemDelta<REAL>::compute(*base, problem);
+         if( !delta )
+         {
+            setBase(problem, solution);
+            delta = ProblemDelta<REAL>::compute(*base, problem);
+            assert(delta && delta->empty( ));
+         }
+         std::shared_ptr<Task> task { new Task( ) };
+         task->job.base = nbases - 1;
+         task->job.settings = settings;
+         task->job.delta = std::move(delta.get( ));
+         task->job.passcodes = parameters.passcodes;
+         task->future = task->promise.get_future( );
+         std::lock_guard<std::mutex> lock(mutex);
+         if( nalive == 0 )
+            return nullptr;
+         task->job.id = njobs++;
+         task->base = payload;
+         queue.push_back(task);
+         condition.notify_one( );
+         return task;
+      }
+
+      /**
+       * waits for the result of the task
+       * @param task
+       * @return result which is invalid if all workers have been lost
+       */
+      WorkerResult
+      wait(const std::shared_ptr<Task>& task)
+      {
+         return task->future.get( );
+      }
+
+      /**
+       * withdraws the task, if it is already running its result is discarded
+       * @param task
+       */
+      void
+      cancel(const std::shared_ptr<Task>& task)
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+         task->cancelled = true;
+         auto position = std::find(queue.begin( ), queue.end( ), task);
+         if( position != queue.end( ) )
+            queue.erase(position);
+      }
+
+      /**
+       * shuts down the sessions of all workers
+       */
+      void
+      stop( )
+      {
+         {
+            std::lock_guard<std::mutex> lock(mutex);
+            if( finished )
+               return;
+            finished = true;
+            condition.notify_all( );
+         }
+         for( const auto& worker: workers )
+            if( worker->thread.joinable( ) )
+               worker->thread.join( );
+         for( const auto& task: queue )
+            task->promise.set_value(WorkerResult { });
+         queue.clear( );
+      }
+
+   private:
+
+      void
+      serve(Worker& worker)
+      {
+         while( true )
+         {
+            std::shared_ptr<Task> task { };
+            {
+               std::unique_lock<std::mutex> lock(mutex);
+               condition.wait(lock, [this]( ) { return finished || !queue.empty( ); });
+               if( finished )
+                  break;
+               task = queue.front( );
+               queue.pop_front( );
+            }
+            WorkerResult result { };
+            if( process(worker, *task, result) )
+            {
+               task->promise.set_value(std::move(result));
+               continue;
+            }
+            msg.warn("Worker {} is lost.\n", worker.address);
+            worker.channel.close( );
+            std::lock_guard<std::mutex> lock(mutex);
+            --nalive;
+            if( !task->cancelled )
+            {
+               ++nrequeued;
+               queue.push_front(task);
+            }
+            if( nalive == 0 )
+            {
+               for( const auto& open: queue )
+                  open->promise.set_value(WorkerResult { });
+               queue.clear( );
+            }
+            condition.notify_all( );
+            return;
+         }
+         worker.channel.send(WorkerMessage::kShutdown, String( ), parameters.worker_timeout);
+         worker.channel.close( );
+      }
+
+      bool
+      process(Worker& worker, const Task& task, WorkerResult& result)
+      {
+         BUGGER_TRACE_SCOPE("worker", "remote", task.job.id);
+         if( worker.base != task.job.base )
+         {
+            if( !worker.channel.send(WorkerMessage::kBase, *task.base, parameters.worker_timeout) )
+               return false;
+            worker.base = task.job.base;
+         }
+         if( !worker.channel.send(WorkerMessage::kJob, WorkerChannel::pack(task.job), parameters.worker_timeout) )
+            return false;
+         WorkerMessage type { };
+         String answer { };
+         do
+         {
+            if( !worker.channel.receive(type, answer, parameters.worker_timeout) )
+               return false;
+         }
+         while( type == WorkerMessage::kHeartbeat );
+         return type == WorkerMessage::kResult && WorkerChannel::unpack(answer, result) && result.id == task.job.id;
+      }
+   };
+
+} // namespace bugger
+
+#endif
@@ -0,0 +1,499 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BUGGER_INTERFACES_EXTERNALINTERFACE_HPP__
+#define __BUGGER_INTERFACES_EXTERNALINTERFACE_HPP__
+
+#include <csignal>
+#include <regex>
+#include <sstream>
+#include <thread>
+#include <sys/stat.h>
+#include <boost/iostreams/device/file_descriptor.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <boost/program_options/parsers.hpp>
+#include "bugger/data/Problem.hpp"
+#include "bugger/data/SolverSettings.hpp"
+#include "bugger/interfaces/BuggerStatus.hpp"
+#include "bugger/interfaces/SolverStatus.hpp"
+#include "bugger/interfaces/SolverInterface.hpp"
+#include "bugger/io/MpsWriter.hpp"
+#include "bugger/io/SolParser.hpp"
+#include "bugger/misc/Process.hpp"
+#include "bugger/misc/Trace.hpp"
+
+
+namespace bugger
+{
+   class ExternalParameters
+   {
+   public:
+
+      String command { };
+      String rules { };
+      bool stream = true;
+      double feastol = 1e-6;
+      double infinity = 1e20;
+   };
+
+   /**
+    * rule translating the output of the external solver, where the first matching exit or match rule determines the
+    * return code and status while effort, dual, primal, solution, and fingerprint rules declare how the output is
+    * evaluated
+    */
+   struct ExternalRule
+   {
+      enum Type : char
+      {
+         EXIT        = 0,
+         MATCH       = 1,
+         EFFORT      = 2,
+         DUAL        = 3,
+         PRIMAL      = 4,
+         SOLUTION    = 5,
+         FINGERPRINT = 6,
+      };
+
+      Type type;
+      int code = 0;
+      std::regex pattern { };
+      char retcode = SolverRetcode::OKAY;
+      SolverStatus status = SolverStatus::kUnknown;
+   };
+
+   template <typename REAL>
+   class ExternalInterface : public SolverInterface<REAL>
+   {
+   private:
+
+      const ExternalParameters& parameters;
+      const Vec<ExternalRule>& rules;
+      long long effort = -1;
+      String fingerprint { };
+
+   public:
+
+      explicit ExternalInterface(const Message& _msg, const ExternalParameters& _parameters, const Vec<ExternalRule>& _rules) :
+                                 SolverInterface<REAL>(_msg), parameters(_parameters), rules(_rules)
+      { }
+
+      void
+      print_header( ) const override
+      {
+         this->msg.info("External solver: {}\n", parameters.command);
+      }
+
+      void
+      doSetUp(SolverSettings& settings, const Problem<REAL>& problem, const Solution<REAL>& solution) override
+      {
+         this->adjustment = &settings;
+         this->model = &problem;
+         this->reference = &solution;
+         if( this->reference->status == SolutionStatus::kFeasible )
+            this->value = this->model->getPrimalObjective(solution);
+         else if( this->reference->status == SolutionStatus::kUnbounded )
+            this->value = this->model->getObjective( ).sense ? -parameters.infinity : parameters.infinity;
+         else if( this->reference->status == SolutionStatus::kInfeasible )
+            this->value = this->model->getObjective( ).sense ? parameters.infinity : -parameters.infinity;
+      }
+
+      std::pair<char, SolverStatus>
+      solve(const Vec<int>& passcodes) override
+      {
+         ScratchDirectory directory { "bugger-external" };
+         String instance = directory.getFile("instance.mps");
+         String solutionfile = directory.getFile("solution.sol");
+         String output = directory.getFile("output.log");
+         int code = run(instance, solutionfile, output);
+
+         std::ifstream file(output);
+         std::stringstream buffer;
+         buffer << file.rdbuf( );
+         String log = buffer.str( );
+         this->msg.detailed("{}", log);
+
+         // exit codes become errors from -1 to -127
+         char retcode = code == 0 ? (char)SolverRetcode::OKAY : (char)-std::min(code, 127);
+         SolverStatus solverstatus = code == 0 ? SolverStatus::kUnknown : SolverStatus::kUndefinedError;
+
+         // translate exit code and output
+         for( const auto& rule : rules )
+         {
+            if( ( rule.type == ExternalRule::EXIT && rule.code == code )
+             || ( rule.type == ExternalRule::MATCH && std::regex_search(log, rule.pattern) ) )
+            {
+               retcode = rule.retcode;
+               solverstatus = rule.status;
+               break;
+            }
+         }
+
+         effort = -1;
+         String effortvalue;
+         for( const auto& rule : rules )
+            if( rule.type == ExternalRule::EFFORT && find_last(log, rule.pattern, effortvalue) )
+               effort = std::max(std::atoll(effortvalue.c_str( )), 0LL);
+
+         fingerprint.clear( );
+         String fingerprintvalue;
+         for( const auto& rule : rules )
+         {
+            if( rule.type == ExternalRule::FINGERPRINT && find_last(log, rule.pattern, fingerprintvalue) )
+            {
+               if( !fingerprint.empty( ) )
+                  fingerprint += ' ';
+               fingerprint += fingerprintvalue;
+            }
+         }
+
+         if( retcode == SolverRetcode::OKAY )
+         {
+            // retrieve enabled checks
+            bool dual = true;
+            bool primal = true;
+            bool objective = true;
+
+            for( int passcode: passcodes )
+            {
+               switch( passcode )
+               {
+               case SolverRetcode::DUALFAIL:
+                  dual = false;
+                  break;
+               case SolverRetcode::PRIMALFAIL:
+                  primal = false;
+                  break;
+               case SolverRetcode::OBJECTIVEFAIL:
+                  objective = false;
+                  break;
+               }
+            }
+
+            // declare primal solution
+            Vec<Solution<REAL>> solution;
+
+            for( const auto& rule : rules )
+            {
+               if( retcode != SolverRetcode::OKAY )
+                  break;
+               String number;
+               switch( rule.type )
+               {
+               // check dual by reference solution objective
+               case ExternalRule::DUAL:
+                  if( dual && find_last(log, rule.pattern, number) )
+                     retcode = this->check_dual_bound( parse_number<REAL>(number), REAL(parameters.feastol), REAL(parameters.infinity) );
+                  break;
+               // check primal by generated solution values
+               case ExternalRule::SOLUTION:
+                  if( ( primal || objective ) && solution.empty( ) )
+                  {
+                     auto values = SolParser<REAL>::readSol(solutionfile, this->model->getVariableNames( ));
+                     if( values )
+                     {
+                        values->status = SolutionStatus::kFeasible;
+                        for( int col = 0; col < this->model->getNCols( ); ++col )
+                           if( this->model->getColFlags( )[ col ].test(ColFlag::kFixed) )
+                              values->primal[ col ] = std::numeric_limits<REAL>::signaling_NaN( );
+                        solution.push_back(std::move(*values));
+                        if( primal )
+                           retcode = this->check_primal_solution( solution, REAL(parameters.feastol), REAL(parameters.infinity) );
+                     }
+                  }
+                  break;
+               // check objective by best solution evaluation
+               case ExternalRule::PRIMAL:
+                  if( objective && find_last(log, rule.pattern, number) )
+                     retcode = this->check_objective_value( parse_number<REAL>(number), solution.empty( ) ? Solution<REAL>(SolutionStatus::kInfeasible) : solution[0], REAL(parameters.feastol), REAL(parameters.infinity) );
+                  break;
+               default:
+                  break;
+               }
+            }
+         }
+
+         // interpret certain passcodes as OKAY based on the user preferences
+         for( int passcode: passcodes )
+         {
+            if( passcode == retcode )
+            {
+               retcode = SolverRetcode::OKAY;
+               break;
+            }
+         }
+
+         return { retcode, solverstatus };
+      }
+
+      long long
+      getSolvingEffort( ) const override
+      {
+         return effort;
+      }
+
+      String
+      getFingerprint( ) const override
+      {
+         return fingerprint;
+      }
+
+   private:
+
+      /**
+       * launches the solver and writes the instance while the solver starts, where the instance is streamed through a
+       * named pipe if possible so that it never touches the disk
+       * @param instance
+       * @param solutionfile
+       * @param output
+       * @return exit code of the solver or 128 plus the signal number if it was killed
+       */
+      int
+      run(const String& instance, const String& solutionfile, const String& output) const
+      {
+         bool stream = parameters.stream && mkfifo(instance.c_str( ), 0600) == 0;
+         if( !stream )
+            MpsWriter<REAL>::writeProb(instance, *this->model);
+
+         Vec<String> arguments { };
+         bool placed = false;
+         for( auto& argument : boost::program_options::split_unix(parameters.command) )
+         {
+            placed |= replace(argument, "{instance}", instance);
+            replace(argument, "{solution}", solutionfile);
+            arguments.push_back(argument);
+         }
+         if( arguments.empty( ) )
+            throw std::runtime_error("external solver command is empty");
+         if( !placed )
+            arguments.push_back(instance);
+
+         pid_t pid = spawn_process(arguments, output);
+         if( pid < 0 )
+            throw std::runtime_error("external solver " + arguments[0] + " could not be started");
+
+         if( stream )
+         {
+            // wait until the solver opens the instance or terminates without reading it
+            int descriptor;
+            while( ( descriptor = open(instance.c_str( ), O_WRONLY | O_NONBLOCK) ) < 0 && ( errno == ENXIO || errno == EINTR )
+                   && !is_process_terminated(pid) )
+               std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            if( descriptor >= 0 )
+            {
+               BUGGER_TRACE_SCOPE("io", "stream");
+               fcntl(descriptor, F_SETFL, fcntl(descriptor, F_GETFL) & ~O_NONBLOCK);
+               boost::iostreams::stream<boost::iostreams::file_descriptor_sink> out(descriptor, boost::iostreams::close_handle);
+               // a solver stopping to read early only breaks the pipe
+               MpsWriter<REAL>::writeProb(out, *this->model);
+            }
+         }
+
+         int code = wait_process(pid);
+         if( code < 0 )
+            throw std::runtime_error("external solver " + arguments[0] + " could not be waited for");
+         return code;
+      }
+
+      /**
+       * replaces all occurrences of the placeholder in the argument
+       * @param argument
+       * @param placeholder
+       * @param value
+       * @return whether the placeholder occurred
+       */
+      static bool
+      replace(String& argument, const String& placeholder, const String& value)
+      {
+         bool found = false;
+         for( size_t position = argument.find(placeholder); position != String::npos; position = argument.find(placeholder, position + value.size( )) )
+         {
+            argument.replace(position, placeholder.size( ), value);
+            found = true;
+         }
+         return found;
+      }
+
+      /**
+       * finds the first group of the last match of the pattern in the log
+       * @param log
+       * @param pattern
+       * @param group
+       * @return whether the pattern matched
+       */
+      static bool
+      find_last(const String& log, const std::regex& pattern, String& group)
+      {
+         bool found = false;
+         for( std::sregex_iterator match(log.begin( ), log.end( ), pattern), end; match != end; ++match )
+         {
+            group = match->size( ) > 1 ? (*match)[1].str( ) : match->str( );
+            found = true;
+         }
+         return found;
+      }
+   };
+
+   template <typename REAL>
+   class ExternalFactory : public SolverFactory<REAL>
+   {
+   private:
+
+      ExternalParameters parameters { };
+      Vec<ExternalRule> rules { };
+      bool initial = true;
+
+   public:
+
+      void
+      addParameters(ParameterSet& parameterset) override
+      {
+         parameterset.addParameter("external.command", "command line of the solver with placeholders {instance} (appended if missing) and {solution}", parameters.command);
+         parameterset.addParameter("external.rules", "file of rules translating exit code and output of the solver", parameters.rules);
+         parameterset.addParameter("external.stream", "stream instances through a named pipe instead of a file", parameters.stream);
+         parameterset.addParameter("external.feastol", "feasibility tolerance to check the output of the solver", parameters.feastol, 0.0, 0.5);
+         parameterset.addParameter("external.infinity", "infinity value to check the output of the solver", parameters.infinity, 1.0);
+      }
+
+      std::unique_ptr<SolverInterface<REAL>>
+      create_solver(const Message& msg) override
+      {
+         if( initial )
+         {
+            if( parameters.command.empty( ) )
+               throw std::runtime_error("external solver command not specified");
+            if( !parameters.rules.empty( ) )
+               rules = parseRules(parameters.rules);
+            // a solver closing the pipe must not terminate the bugger
+            if( parameters.stream )
+               std::signal(SIGPIPE, SIG_IGN);
+            initial = false;
+         }
+         return std::unique_ptr<SolverInterface<REAL>>( new ExternalInterface<REAL>( msg, parameters, rules ) );
+      }
+
+   private:
+
+      /**
+       * parses the rule file with one rule per line and comments starting with #
+       *   exit <code> <retcode> <status>
+       *   match <regex> <retcode> <status>
+       *   effort <regex>
+       *   dual <regex>
+       *   primal <regex>
+       *   solution
+       *   fingerprint <regex>
+       * where the first group of a regex captures the value and status is printed as in the log
+       * @param filename
+       */
+      static Vec<ExternalRule>
+      parseRules(const String& filename)
+      {
+         std::ifstream file(filename);
+         if( !file )
+            throw std::runtime_error("could not open external rules " + filename);
+
+         Vec<ExternalRule> result { };
+         String line;
+         for( int number = 1; std::getline(file, line); ++number )
+         {
+            size_t comment = line.find('#');
+            if( comment != String::npos )
+               line.erase(comment);
+            auto tokens = boost::program_options::split_unix(line);
+            if( tokens.empty( ) )
+               continue;
+            try
+            {
+               ExternalRule rule { };
+               const String& type = tokens[0];
+               size_t length;
+               if( type == "exit" || type == "match" )
+               {
+                  length = 4;
+                  if( tokens.size( ) == length )
+                  {
+                     rule.type = type == "exit" ? ExternalRule::EXIT : ExternalRule::MATCH;
+                     if( rule.type == ExternalRule::EXIT )
+                        rule.code = std::stoi(tokens[1]);
+                     else
+                        rule.pattern = std::regex(tokens[1]);
+                     rule.retcode = (char)std::stoi(tokens[2]);
+                     rule.status = parseStatus(tokens[3]);
+                  }
+               }
+               else if( type == "effort" || type == "dual" || type == "primal" || type == "fingerprint" )
+               {
+                  length = 2;
+                  if( tokens.size( ) == length )
+                  {
+                     rule.type = type == "effort" ? ExternalRule::EFFORT : type == "dual" ? ExternalRule::DUAL
+                               : type == "primal" ? ExternalRule::PRIMAL : ExternalRule::FINGERPRINT;
+                     rule.pattern = std::regex(tokens[1]);
+                  }
+               }
+               else if( type == "solution" )
+               {
+                  length = 1;
+                  rule.type = ExternalRule::SOLUTION;
+               }
+               else
+                  throw std::invalid_argument("unknown rule " + type);
+               if( tokens.size( ) != length )
+                  throw std::invalid_argument("rule " + type + " expects " + std::to_string(length - 1) + " arguments");
+               result.push_back(std::move(rule));
+            }
+            catch( const std::exception& exception )
+            {
+               throw std::runtime_error(fmt::format("invalid external rule in {} line {}: {}", filename, number, exception.what( )));
+            }
+         }
+         return result;
+      }
+
+      static SolverStatus
+      parseStatus(const String& name)
+      {
+         for( int value = (int)SolverStatus::kUndefinedError; value <= (int)SolverStatus::kInterrupt; ++value )
+         {
+            if( !SolverStatusCheck::is_value(value) )
+               continue;
+            std::ostringstream stream;
+            stream << SolverStatus(value);
+            if( stream.str( ) == name )
+               return SolverStatus(value);
+         }
+         throw std::invalid_argument("unknown status " + name);
+      }
+   };
+
+   template <typename REAL>
+   std::shared_ptr<SolverFactory<REAL>>
+   load_solver_factory( )
+   {
+      return std::shared_ptr<SolverFactory<REAL>>( new ExternalFactory<REAL>( ) );
+   }
+
+} // namespace bugger
+
+#endif
@@ -34,6 +34,9 @@
 #include "bugger/interfaces/BuggerStatus.hpp"
 #include "bugger/interfaces/SolverStatus.hpp"
 #include "bugger/interfaces/SolverInterface.hpp"
+#ifdef SCIP_WITH_EXACTSOLVE
+#include "bugger/misc/Process.hpp"
+#endif
 
 
 namespace bugger
@@ -84,12 +87,20 @@ namespace bugger
       const HashMap<String, char>& limits;
       SCIP* scip = nullptr;
       Vec<SCIP_VAR*> vars { };
+#ifdef SCIP_WITH_EXACTSOLVE
+      // unique location of the certificate files so that solves can run concurrently
+      std::unique_ptr<ScratchDirectory> directory { };
+#endif
 
    public:
 
       ScipInterface(const Message& _msg, const ScipParameters& _parameters, const HashMap<String, char>& _limits) :
                     SolverInterface<REAL>(_msg), parameters(_parameters), limits(_limits)
       {
+#ifdef SCIP_WITH_EXACTSOLVE
+         if( parameters.certificate )
+            directory.reset(new ScratchDirectory("bugger-vipr"));
+#endif
          if( SCIPcreate(&scip) != SCIP_OKAY || SCIPincludeDefaultPlugins(scip) != SCIP_OKAY )
             throw std::runtime_error("could not create SCIP");
       }
@@ -334,7 +345,7 @@ namespace bugger
             assert(false);
          }
 
-         SCIP_CALL_ABORT(SCIPsetStringParam(scip, ScipParameters::CERT.c_str(), parameters.certificate ? "certificate.vipr" : "-"));
+         SCIP_CALL_ABORT(SCIPsetStringParam(scip, ScipParameters::CERT.c_str(), directory ? directory->getFile("certificate.vipr").c_str( ) : "-"));
 #endif
       }
    };
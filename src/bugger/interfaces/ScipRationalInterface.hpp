@@ -139,9 +139,9 @@ namespace bugger
             SCIP_CALL_ABORT(SCIPreleaseVar(this->scip, &var));
          }
 
-         Vec<SCIP_VAR*> consvars(ncols);
-         Vec<SCIP_RATIONAL> buffer(ncols);
-         Vec<SCIP_RATIONAL*> consvals(ncols);
+         ScratchVec<SCIP_VAR*> consvars(ncols);
+         ScratchVec<SCIP_RATIONAL> buffer(ncols);
+         ScratchVec<SCIP_RATIONAL*> consvals(ncols);
          for( int col = 0; col < ncols; ++col )
             consvals[col] = buffer.data() + col;
          for( int row = 0; row < nrows; ++row )
@@ -416,9 +416,9 @@ namespace bugger
             {
                SCIPfreeTransform(this->scip);
 
-               if( system("viprcomp certificate.vipr >/dev/null") )
+               if( run_process({ "viprcomp", this->directory->getFile("certificate.vipr") }) )
                   retcode = SolverRetcode::COMPLETIONFAIL;
-               else if( system("viprchk certificate_complete.vipr >/dev/null") )
+               else if( run_process({ "viprchk", this->directory->getFile("certificate_complete.vipr") }) )
                   retcode = SolverRetcode::CERTIFICATIONFAIL;
             }
          }
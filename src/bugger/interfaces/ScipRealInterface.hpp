@@ -103,8 +103,8 @@ namespace bugger
             SCIP_CALL_ABORT(SCIPreleaseVar(this->scip, &var));
          }
 
-         Vec<SCIP_VAR*> consvars(ncols);
-         Vec<SCIP_Real> consvals(ncols);
+         ScratchVec<SCIP_VAR*> consvars(ncols);
+         ScratchVec<SCIP_Real> consvals(ncols);
          for( int row = 0; row < nrows; ++row )
          {
             if( rflags[row].test(RowFlag::kRedundant) )
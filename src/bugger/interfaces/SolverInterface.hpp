@@ -116,6 +116,41 @@ namespace bugger
       std::pair<char, SolverStatus>
       solve(const Vec<int>& passcodes) = 0;
 
+      /** **optional**
+       * @return whether solveLimited() restricts the solving effort to the budget
+       * _if not overridden, then proxy solves are disabled_
+       */
+      virtual
+      bool
+      hasLimitedSolve( ) const
+      {
+         return false;
+      }
+
+      /** **optional**
+       * solves the instance with the solving effort restricted to a budget
+       * _if not overridden, then the budget is ignored and the instance solved completely_
+       * @param passcodes suppress certain codes as in solve()
+       * @param budget limit on the solving effort in the measure of getSolvingEffort()
+       * @return boost::none if the budget was exhausted before the solve was finished, otherwise the pair of solve()
+       */
+      virtual
+      boost::optional<std::pair<char, SolverStatus>>
+      solveLimited(const Vec<int>& passcodes, long long budget)
+      {
+         return solve(passcodes);
+      }
+
+      /** **optional**
+       * informs that the last solve reproduced the issue and its batch is accepted
+       * _if not overridden, then nothing is kept from the solve, otherwise for example warm start information_
+       */
+      virtual
+      void
+      acceptSolve( )
+      {
+      }
+
       /** **optional**
        * provides measure for the solving effort to adapt batch number
        * _if returned -1 initially, then automatic batch adaption will be deactivated_
@@ -128,6 +163,18 @@ namespace bugger
          return -1;
       }
 
+      /** **optional**
+       * provides a fingerprint of the solver log to distinguish failures with equal return code and status
+       * _if returned empty, then failures can only be pinned by return code, status, and effort_
+       * @return a String: Characteristic excerpt of the log of the last solve
+       */
+      virtual
+      String
+      getFingerprint( ) const
+      {
+         return { };
+      }
+
       /** **optional**
        * read setting-problem-solution tuple from files
        * _if returned boost::none for setting, modifier Setting will be deactivated_
@@ -69,6 +69,14 @@ namespace bugger
       bool set_refi_limit = true;
       bool set_iter_limit = false;
       bool set_time_limit = false;
+      bool warmstart = true;
+   };
+
+   /// basis statuses of the columns and rows of the last reproducing problem in bugger indices
+   struct SoplexBasis
+   {
+      Vec<SPxSolver::VarStatus> cols { };
+      Vec<SPxSolver::VarStatus> rows { };
    };
 
    const SoPlex::IntParam SoplexParameters::VERB { SoPlex::VERBOSITY };
@@ -84,19 +92,25 @@ namespace bugger
    {
    protected:
 
-      static bool initial;
+      bool& initial;
 
       SoplexParameters& parameters;
+      SoplexBasis& basis;
       HashMap<String, char>& limits;
       SoPlex* soplex = nullptr;
       NameSet colNames { };
       NameSet rowNames { };
       Vec<int> inds { };
+      Vec<int> rows { };
+      // basis of the last reproducing solve, which is shared with the factory once its batch is accepted
+      SoplexBasis candidate { };
+      bool hascandidate = false;
 
    public:
 
-      SoplexInterface(const Message& _msg, SoplexParameters& _parameters, HashMap<String, char>& _limits) :
-                      SolverInterface<REAL>(_msg), parameters(_parameters), limits(_limits)
+      SoplexInterface(const Message& _msg, SoplexParameters& _parameters, HashMap<String, char>& _limits, bool& _initial,
+                      SoplexBasis& _basis) :
+                      SolverInterface<REAL>(_msg), initial(_initial), parameters(_parameters), basis(_basis), limits(_limits)
       {
          soplex = new SoPlex();
       }
@@ -293,6 +307,30 @@ namespace bugger
          return SolverSettings(bool_settings, int_settings, long_settings, double_settings,char_settings, string_settings, limit_settings);
       }
 
+      bool
+      hasLimitedSolve( ) const override
+      {
+         return true;
+      }
+
+      boost::optional<std::pair<char, SolverStatus>>
+      solveLimited(const Vec<int>& passcodes, long long budget) override
+      {
+         int limit = soplex->intParam(SoPlex::ITERLIMIT);
+         // keep a tighter iteration limit of the settings to preserve their outcome
+         bool restrict = budget < INT_MAX && ( limit < 0 || budget < limit );
+         if( restrict )
+            SOPLEX_CALL_ABORT(soplex->setIntParam(SoPlex::ITERLIMIT, (int)budget));
+         std::pair<char, SolverStatus> result = this->solve(passcodes);
+         if( restrict )
+         {
+            SOPLEX_CALL_ABORT(soplex->setIntParam(SoPlex::ITERLIMIT, limit));
+            if( soplex->status() == SPxSolver::ABORT_ITER )
+               return boost::none;
+         }
+         return result;
+      }
+
       long long
       getSolvingEffort( ) const override
       {
@@ -345,8 +383,132 @@ namespace bugger
          set_arithmetic( );
       }
 
+      /**
+       * loads the stored basis mapped to the current problem, where dropped rows are regarded as basic slacks and fixed
+       * columns as nonbasic, so that the number of basic variables is repaired afterwards
+       */
+      void
+      load_basis( ) const
+      {
+         int ncols = this->model->getNCols( );
+         int nrows = this->model->getNRows( );
+         if( !parameters.warmstart || (int)basis.cols.size( ) != ncols || (int)basis.rows.size( ) != nrows )
+            return;
+         const auto& domains = this->model->getVariableDomains( );
+         const auto& consMatrix = this->model->getConstraintMatrix( );
+         const auto& lhs_values = consMatrix.getLeftHandSides( );
+         const auto& rhs_values = consMatrix.getRightHandSides( );
+         const auto& cflags = this->model->getColFlags( );
+         const auto& rflags = this->model->getRowFlags( );
+         Vec<SPxSolver::VarStatus> colstatus(soplex->numCols( ));
+         Vec<SPxSolver::VarStatus> rowstatus(soplex->numRows( ));
+         int nbasics = 0;
+         for( int col = 0; col < ncols; ++col )
+         {
+            if( inds[col] < 0 )
+               continue;
+            bool lowerinf = cflags[col].test(ColFlag::kLbInf);
+            bool upperinf = cflags[col].test(ColFlag::kUbInf);
+            // fixed columns leave the basis, whose size is repaired by slacks below
+            if( !lowerinf && !upperinf && domains.lower_bounds[col] == domains.upper_bounds[col] )
+               colstatus[inds[col]] = SPxSolver::FIXED;
+            else
+               colstatus[inds[col]] = get_status(basis.cols[col], lowerinf, upperinf, false);
+            if( colstatus[inds[col]] == SPxSolver::BASIC )
+               ++nbasics;
+         }
+         for( int row = 0; row < nrows; ++row )
+         {
+            if( rows[row] < 0 )
+               continue;
+            bool lhsinf = rflags[row].test(RowFlag::kLhsInf);
+            bool rhsinf = rflags[row].test(RowFlag::kRhsInf);
+            rowstatus[rows[row]] = get_status(basis.rows[row], lhsinf, rhsinf,
+                                              !lhsinf && !rhsinf && lhs_values[row] == rhs_values[row]);
+            if( rowstatus[rows[row]] == SPxSolver::BASIC )
+               ++nbasics;
+         }
+         for( int col = ncols - 1; nbasics > soplex->numRows( ) && col >= 0; --col )
+         {
+            if( inds[col] < 0 || colstatus[inds[col]] != SPxSolver::BASIC )
+               continue;
+            bool lowerinf = cflags[col].test(ColFlag::kLbInf);
+            bool upperinf = cflags[col].test(ColFlag::kUbInf);
+            colstatus[inds[col]] = get_status(SPxSolver::ZERO, lowerinf, upperinf,
+                                              !lowerinf && !upperinf && domains.lower_bounds[col] == domains.upper_bounds[col]);
+            --nbasics;
+         }
+         for( int row = 0; nbasics < soplex->numRows( ) && row < soplex->numRows( ); ++row )
+         {
+            if( rowstatus[row] == SPxSolver::BASIC )
+               continue;
+            rowstatus[row] = SPxSolver::BASIC;
+            ++nbasics;
+         }
+         soplex->setBasis(rowstatus.data( ), colstatus.data( ));
+      }
+
+      /**
+       * stores the basis of the current problem if available as candidate until the solve is accepted
+       */
+      void
+      store_basis( )
+      {
+         int ncols = this->model->getNCols( );
+         int nrows = this->model->getNRows( );
+         if( !parameters.warmstart || !soplex->hasBasis( ) )
+            return;
+         Vec<SPxSolver::VarStatus> colstatus(soplex->numCols( ));
+         Vec<SPxSolver::VarStatus> rowstatus(soplex->numRows( ));
+         soplex->getBasis(rowstatus.data( ), colstatus.data( ));
+         candidate = basis;
+         candidate.cols.resize(ncols, SPxSolver::ZERO);
+         candidate.rows.resize(nrows, SPxSolver::BASIC);
+         for( int col = 0; col < ncols; ++col )
+            if( inds[col] >= 0 )
+               candidate.cols[col] = colstatus[inds[col]];
+         for( int row = 0; row < nrows; ++row )
+            candidate.rows[row] = rows[row] >= 0 ? rowstatus[rows[row]] : SPxSolver::BASIC;
+         hascandidate = true;
+      }
+
+      /**
+       * shares the basis of the accepted solve with the factory to warm start the following solves
+       */
+      void
+      acceptSolve( ) override
+      {
+         if( !hascandidate )
+            return;
+         basis = std::move(candidate);
+         hascandidate = false;
+      }
+
    private:
 
+      /**
+       * returns a status consistent with the bounds
+       * @param status
+       * @param lowerinf
+       * @param upperinf
+       * @param fixed
+       */
+      static SPxSolver::VarStatus
+      get_status(SPxSolver::VarStatus status, bool lowerinf, bool upperinf, bool fixed)
+      {
+         if( status == SPxSolver::BASIC )
+            return status;
+         if( fixed )
+            return SPxSolver::FIXED;
+         if( ( status == SPxSolver::ON_LOWER && !lowerinf ) || ( status == SPxSolver::ON_UPPER && !upperinf ) )
+            return status;
+         if( !lowerinf )
+            return SPxSolver::ON_LOWER;
+         if( !upperinf )
+            return SPxSolver::ON_UPPER;
+         return SPxSolver::ZERO;
+      }
+
       void
       set_arithmetic( ) const
       {
@@ -371,9 +533,6 @@ namespace bugger
       }
    };
 
-   template <typename REAL>
-   bool SoplexInterface<REAL>::initial = true;
-
 } // namespace bugger
 
 #include "SoplexRealInterface.hpp"
@@ -390,6 +549,10 @@ namespace bugger
       SoplexParameters parameters { };
       HashMap<String, char> limits { };
       bool initial = true;
+      // objective differences are initialized per factory so that concurrent sessions do not interfere
+      bool setup = true;
+      // basis of the last reproducing problem to warm start the solves of the factory
+      SoplexBasis basis { };
 
    public:
 
@@ -404,6 +567,7 @@ namespace bugger
          parameterset.addParameter("soplex.setrefilimit", "restrict number of refinements automatically", parameters.set_refi_limit);
          parameterset.addParameter("soplex.setiterlimit", "restrict number of iterations automatically (effortbounding)", parameters.set_iter_limit);
          parameterset.addParameter("soplex.settimelimit", "restrict time automatically (unreproducible)", parameters.set_time_limit);
+         parameterset.addParameter("soplex.warmstart", "start from the basis of the last reproducing problem instead of solving cold (affecting)", parameters.warmstart);
          // stalling number of refinements is unrestrictable because it is not monotonously increasing
       }
 
@@ -416,12 +580,12 @@ namespace bugger
          case 0:
             if( initial && (soplex::Real)std::numeric_limits<REAL>::epsilon() > std::numeric_limits<soplex::Real>::epsilon() )
                msg.warn("Selected bugger arithmetic less precise than SoPlex real arithmetic.\n");
-            soplex = std::unique_ptr<SolverInterface<REAL>>( new SoplexRealInterface<REAL>( msg, parameters, limits ) );
+            soplex = std::unique_ptr<SolverInterface<REAL>>( new SoplexRealInterface<REAL>( msg, parameters, limits, setup, basis ) );
             break;
          case 1:
             if( initial && (soplex::Rational)std::numeric_limits<REAL>::epsilon() > std::numeric_limits<soplex::Rational>::epsilon() )
                msg.warn("Selected bugger arithmetic less precise than SoPlex rational arithmetic.\n");
-            soplex = std::unique_ptr<SolverInterface<REAL>>( new SoplexRationalInterface<REAL>( msg, parameters, limits ) );
+            soplex = std::unique_ptr<SolverInterface<REAL>>( new SoplexRationalInterface<REAL>( msg, parameters, limits, setup, basis ) );
             break;
          default:
             throw std::runtime_error("unknown solver arithmetic");
@@ -42,8 +42,8 @@ namespace bugger
    public:
 
       explicit SoplexRationalInterface(const Message& _msg, SoplexParameters& _parameters,
-                                       HashMap<String, char>& _limits) :
-                                       SoplexInterface<REAL>(_msg, _parameters, _limits)
+                                       HashMap<String, char>& _limits, bool& _initial, SoplexBasis& _basis) :
+                                       SoplexInterface<REAL>(_msg, _parameters, _limits, _initial, _basis)
       { }
 
       void
@@ -71,6 +71,7 @@ namespace bugger
          this->colNames.reMax(ncols);
          this->rowNames.reMax(nrows);
          this->inds.resize(ncols);
+         this->rows.resize(nrows);
          if( solution_exists )
             this->value = this->model->getPrimalObjective(solution);
          else if( this->reference->status == SolutionStatus::kUnbounded )
@@ -101,6 +102,7 @@ namespace bugger
 
          for( int row = 0; row < nrows; ++row )
          {
+            this->rows[row] = -1;
             if( rflags[row].test(RowFlag::kRedundant) )
                continue;
             assert(!rflags[row].test(RowFlag::kLhsInf) || !rflags[row].test(RowFlag::kRhsInf));
@@ -121,6 +123,7 @@ namespace bugger
                assert(rowvals[i] != 0);
                cons.add(this->inds[rowinds[i]], SOPLEX_Real(rowvals[i]));
             }
+            this->rows[row] = this->soplex->numRows();
             this->soplex->addRowRational(LPRowRational(lhs, cons, rhs));
             this->rowNames.add(consNames[row].c_str());
          }
@@ -178,7 +181,10 @@ namespace bugger
 
          // optimize
          if( this->parameters.mode == -1 )
+         {
+            this->load_basis( );
             retcode = this->soplex->solve();
+         }
 
          if( retcode > SPxSolver::NOT_INIT )
          {
@@ -292,6 +298,9 @@ namespace bugger
                break;
             }
          }
+         // keep basis of reproducing problem until its batch is accepted
+         if( retcode != SolverRetcode::OKAY )
+            this->store_basis( );
          // restrict limit settings
          if( retcode != SolverRetcode::OKAY )
          {
@@ -0,0 +1,515 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _BUGGER_IO_COMPRESSION_HPP_
+#define _BUGGER_IO_COMPRESSION_HPP_
+
+#include "bugger/misc/String.hpp"
+#include "bugger/misc/Vec.hpp"
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/iostreams/concepts.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_ZLIB
+#include <boost/iostreams/filter/gzip.hpp>
+#endif
+#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_BZIP2
+#include <boost/iostreams/filter/bzip2.hpp>
+#endif
+#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_ZSTD
+#include <boost/iostreams/filter/zstd.hpp>
+#endif
+#ifdef BUGGER_TBB
+#include "bugger/misc/tbb.hpp"
+#endif
+
+namespace bugger
+{
+
+enum class Codec
+{
+   kNone,
+   kGzip,
+   kBzip2,
+   kZstd
+};
+
+/// codec of a file by its extension, where codecs unavailable in the build
+/// are none
+inline Codec
+getCodec( const String& filename )
+{
+#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_ZLIB
+   if( boost::algorithm::ends_with( filename, ".gz" ) )
+      return Codec::kGzip;
+#endif
+#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_BZIP2
+   if( boost::algorithm::ends_with( filename, ".bz2" ) )
+      return Codec::kBzip2;
+#endif
+#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_ZSTD
+   if( boost::algorithm::ends_with( filename, ".zst" ) )
+      return Codec::kZstd;
+#endif
+   return Codec::kNone;
+}
+
+/// pushes the compressor of the codec onto the stream
+template <typename STREAM>
+void
+pushCompressor( STREAM& stream, Codec codec )
+{
+   switch( codec )
+   {
+   case Codec::kNone:
+      break;
+#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_ZLIB
+   case Codec::kGzip:
+      stream.push( boost::iostreams::gzip_compressor() );
+      break;
+#endif
+#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_BZIP2
+   case Codec::kBzip2:
+      stream.push( boost::iostreams::bzip2_compressor() );
+      break;
+#endif
+#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_ZSTD
+   case Codec::kZstd:
+      stream.push( boost::iostreams::zstd_compressor() );
+      break;
+#endif
+   default:
+      assert( false );
+   }
+}
+
+/// pushes the decompressor of the codec onto the stream
+template <typename STREAM>
+void
+pushDecompressor( STREAM& stream, Codec codec )
+{
+   switch( codec )
+   {
+   case Codec::kNone:
+      break;
+#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_ZLIB
+   case Codec::kGzip:
+      stream.push( boost::iostreams::gzip_decompressor() );
+      break;
+#endif
+#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_BZIP2
+   case Codec::kBzip2:
+      stream.push( boost::iostreams::bzip2_decompressor() );
+      break;
+#endif
+#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_ZSTD
+   case Codec::kZstd:
+      stream.push( boost::iostreams::zstd_decompressor() );
+      break;
+#endif
+   default:
+      assert( false );
+   }
+}
+
+/// Sink which compresses blocks of fixed size in parallel into independent
+/// gzip members, bzip2 streams, or zstd frames and writes them in order, so
+/// that the file is valid for every decompressor of the codec
+class BlockCompressor : public boost::iostreams::sink
+{
+ public:
+   struct category : boost::iostreams::sink_tag, boost::iostreams::closable_tag
+   {
+   };
+
+   /// uncompressed size of a block
+   static constexpr std::size_t blocksize = 1 << 20;
+
+   BlockCompressor( const String& filename, Codec codec, int nblocks )
+       : state( std::make_shared<State>() )
+   {
+      state->file.open( filename, std::ofstream::out | std::ofstream::binary );
+      state->codec = codec;
+      state->blocks.resize( std::max( nblocks, 1 ) );
+      state->block.reserve( blocksize );
+   }
+
+   bool
+   is_open() const
+   {
+      return state->file.is_open();
+   }
+
+   std::streamsize
+   write( const char* s, std::streamsize n )
+   {
+      std::streamsize written = 0;
+
+      while( written < n )
+      {
+         std::size_t size = std::min( blocksize - state->block.size(),
+                                      static_cast<std::size_t>( n - written ) );
+         state->block.append( s + written, size );
+         written += size;
+
+         if( state->block.size() == blocksize )
+            finishBlock();
+      }
+
+      return n;
+   }
+
+   void
+   close()
+   {
+      // a file without any member is not accepted by all decompressors
+      if( !state->block.empty() || state->nwritten == 0 )
+         finishBlock();
+      compressBlocks();
+      state->file.close();
+   }
+
+ private:
+   struct State
+   {
+      std::ofstream file;
+      Codec codec;
+      String block;
+      Vec<String> blocks;
+      int nblocks = 0;
+      long long nwritten = 0;
+   };
+
+   std::shared_ptr<State> state;
+
+   void
+   finishBlock()
+   {
+      state->blocks[state->nblocks].swap( state->block );
+      state->block.clear();
+      ++state->nwritten;
+      if( ++state->nblocks == static_cast<int>( state->blocks.size() ) )
+         compressBlocks();
+   }
+
+   void
+   compressBlocks()
+   {
+      Vec<String> members( state->nblocks );
+      auto compress = [&]( int i ) {
+         boost::iostreams::filtering_ostream out;
+         pushCompressor( out, state->codec );
+         out.push( boost::iostreams::back_inserter( members[i] ) );
+         out.write( state->blocks[i].data(),
+                    static_cast<std::streamsize>( state->blocks[i].size() ) );
+         // closing the chain finishes the member
+         out.reset();
+      };
+
+#ifdef BUGGER_TBB
+      tbb::parallel_for( tbb::blocked_range<int>( 0, state->nblocks, 1 ),
+                         [&]( const tbb::blocked_range<int>& r ) {
+                            for( int i = r.begin(); i != r.end(); ++i )
+                               compress( i );
+                         } );
+#else
+      for( int i = 0; i < state->nblocks; ++i )
+         compress( i );
+#endif
+
+      for( int i = 0; i < state->nblocks; ++i )
+      {
+         state->file.write( members[i].data(),
+                            static_cast<std::streamsize>( members[i].size() ) );
+         state->blocks[i].clear();
+      }
+      state->nblocks = 0;
+   }
+};
+
+/// Source which decompresses the file in a separate thread into a bounded
+/// queue of blocks ahead of the reader, so that parsing overlaps with
+/// decompression, and which throws to the reader if decompression fails
+class PipelinedDecompressor : public boost::iostreams::source
+{
+ public:
+   /// decompressed size of a block
+   static constexpr std::size_t blocksize = 1 << 20;
+
+   /// maximum number of decompressed blocks waiting for the reader
+   static constexpr std::size_t nqueued = 4;
+
+   PipelinedDecompressor( const String& filename, Codec codec )
+       : state( std::make_shared<State>() )
+   {
+      state->file.open( filename, std::ifstream::in | std::ifstream::binary );
+      if( !state->file )
+         return;
+      state->filename = filename;
+      state->codec = codec;
+      pushDecompressor( state->in, codec );
+      state->in.push( state->file );
+      // errors of the codec reach the thread as exceptions instead of a
+      // failed stream that looks like the end of the file
+      state->in.exceptions( std::ios_base::badbit );
+      state->thread = std::thread( [pointer = state.get()]() { decompress( *pointer ); } );
+   }
+
+   bool
+   is_open() const
+   {
+      return state->thread.joinable();
+   }
+
+   std::streamsize
+   read( char* s, std::streamsize n )
+   {
+      if( state->position == state->current.size() )
+      {
+         std::unique_lock<std::mutex> lock( state->mutex );
+         state->ready.wait( lock, [this]() { return !state->queue.empty() || state->finished; } );
+         if( state->queue.empty() )
+         {
+            if( state->error )
+               std::rethrow_exception( state->error );
+            return -1;
+         }
+         state->current.swap( state->queue.front() );
+         state->queue.pop_front();
+         state->position = 0;
+         lock.unlock();
+         state->ready.notify_one();
+      }
+
+      std::size_t size = std::min( state->current.size() - state->position,
+                                   static_cast<std::size_t>( n ) );
+      std::copy_n( state->current.data() + state->position, size, s );
+      state->position += size;
+      return static_cast<std::streamsize>( size );
+   }
+
+ private:
+   struct State
+   {
+      std::ifstream file;
+      String filename;
+      Codec codec;
+      boost::iostreams::filtering_istream in;
+      std::thread thread;
+      std::mutex mutex;
+      std::condition_variable ready;
+      std::deque<String> queue;
+      String current;
+      std::size_t position = 0;
+      std::exception_ptr error;
+      bool finished = false;
+      bool stopped = false;
+
+      ~State()
+      {
+         if( !thread.joinable() )
+            return;
+         {
+            std::lock_guard<std::mutex> lock( mutex );
+            stopped = true;
+         }
+         ready.notify_all();
+         thread.join();
+      }
+   };
+
+   std::shared_ptr<State> state;
+
+   static unsigned long long
+   readLittleEndian( std::ifstream& file, int nbytes )
+   {
+      unsigned long long value = 0;
+      for( int i = 0; i < nbytes; ++i )
+         value |= static_cast<unsigned long long>(
+                      static_cast<unsigned char>( file.get() ) )
+                  << ( 8 * i );
+      return value;
+   }
+
+   /// whether the file consists of complete zstd frames, which are walked by
+   /// their headers without decompressing them
+   static bool
+   isCompleteZstd( const String& filename )
+   {
+      std::ifstream file( filename, std::ifstream::in | std::ifstream::binary );
+      file.seekg( 0, std::ios_base::end );
+      const long long size = static_cast<long long>( file.tellg() );
+      long long position = 0;
+      while( file && position < size )
+      {
+         file.seekg( position );
+         const unsigned long long magic = readLittleEndian( file, 4 );
+         if( ( magic & 0xFFFFFFF0ULL ) == 0x184D2A50ULL )
+         {
+            position += 8 + static_cast<long long>( readLittleEndian( file, 4 ) );
+            continue;
+         }
+         if( magic != 0xFD2FB528ULL )
+            return false;
+         const int descriptor = file.get();
+         const int sizeflag = descriptor >> 6;
+         const bool single = ( descriptor & 0x20 ) != 0;
+         const int checksum = ( descriptor & 0x04 ) != 0 ? 4 : 0;
+         const int dictionary = ( descriptor & 0x03 ) == 3 ? 4 : ( descriptor & 0x03 );
+         const int contentsize = sizeflag == 0 ? ( single ? 1 : 0 ) : 1 << sizeflag;
+         position += 5 + ( single ? 0 : 1 ) + dictionary + contentsize;
+         bool last = false;
+         while( file && !last && position + 3 <= size )
+         {
+            file.seekg( position );
+            const unsigned long long header = readLittleEndian( file, 3 );
+            last = ( header & 1 ) != 0;
+            const int type = static_cast<int>( ( header >> 1 ) & 3 );
+            if( type == 3 )
+               return false;
+            position += 3 + ( type == 1 ? 1 : static_cast<long long>( header >> 3 ) );
+         }
+         if( !last )
+            return false;
+         position += checksum;
+      }
+      return static_cast<bool>( file ) && position == size;
+   }
+
+   static void
+   decompress( State& state )
+   {
+      while( true )
+      {
+         String block( blocksize, '\0' );
+         std::exception_ptr error;
+         try
+         {
+            state.in.read( &block[0], static_cast<std::streamsize>( blocksize ) );
+            // a stream failing before its end is corrupt as well
+            if( !state.in && !state.in.eof() )
+               throw std::ios_base::failure( "unexpected end of data" );
+            // the zstd filter ends silently within a frame of a truncated file
+            if( !state.in && state.codec == Codec::kZstd &&
+                !isCompleteZstd( state.filename ) )
+               throw std::ios_base::failure( "truncated frame" );
+         }
+         catch( const std::exception& exception )
+         {
+            error = std::make_exception_ptr( std::runtime_error(
+                "decompression of " + state.filename + " failed: " + exception.what() ) );
+         }
+         block.resize( static_cast<std::size_t>( state.in.gcount() ) );
+         bool last = !state.in || error;
+
+         std::unique_lock<std::mutex> lock( state.mutex );
+         state.ready.wait( lock, [&]() { return state.queue.size() < nqueued || state.stopped; } );
+         if( state.stopped )
+            return;
+         if( !block.empty() )
+            state.queue.push_back( std::move( block ) );
+         if( last )
+         {
+            state.error = error;
+            state.finished = true;
+            lock.unlock();
+            state.ready.notify_all();
+            return;
+         }
+         lock.unlock();
+         state.ready.notify_all();
+      }
+   }
+};
+
+/// opens the file for reading and pushes it onto the stream, decompressed in
+/// a separate thread if its extension names a codec, returns false if the
+/// file cannot be opened
+inline bool
+openInput( boost::iostreams::filtering_istream& in, const String& filename )
+{
+   Codec codec = getCodec( filename );
+
+   if( codec == Codec::kNone )
+   {
+      boost::iostreams::file_source file( filename );
+      if( !file.is_open() )
+         return false;
+      in.push( file );
+      return true;
+   }
+
+   PipelinedDecompressor source( filename, codec );
+   if( !source.is_open() )
+      return false;
+   in.push( source );
+   // the reader throws the error of the decompression instead of stopping
+   in.exceptions( std::ios_base::badbit );
+   return true;
+}
+
+/// opens the file for writing and pushes it onto the stream, compressed by
+/// the codec its extension names, in parallel blocks with TBB, returns false
+/// if the file cannot be opened
+inline bool
+openOutput( boost::iostreams::filtering_ostream& out, const String& filename )
+{
+   Codec codec = getCodec( filename );
+
+#ifdef BUGGER_TBB
+   if( codec != Codec::kNone )
+   {
+      BlockCompressor sink( filename, codec,
+                            tbb::this_task_arena::max_concurrency() );
+      if( !sink.is_open() )
+         return false;
+      out.push( sink );
+      return true;
+   }
+#endif
+
+   boost::iostreams::file_sink file( filename, codec == Codec::kNone
+                                                   ? std::ios_base::out
+                                                   : std::ios_base::out | std::ios_base::binary );
+   if( !file.is_open() )
+      return false;
+   pushCompressor( out, codec );
+   out.push( file );
+   return true;
+}
+
+} // namespace bugger
+
+#endif
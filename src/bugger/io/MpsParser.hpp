@@ -30,15 +30,10 @@
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/spirit/include/qi.hpp>
 #include "bugger/data/Problem.hpp"
+#include "bugger/io/Compression.hpp"
 #include "bugger/misc/Hash.hpp"
 #include "bugger/misc/Num.hpp"
-
-#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_ZLIB
-#include <boost/iostreams/filter/gzip.hpp>
-#endif
-#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_BZIP2
-#include <boost/iostreams/filter/bzip2.hpp>
-#endif
+#include "bugger/misc/Trace.hpp"
 
 
 namespace bugger
@@ -52,6 +47,7 @@ public:
    static boost::optional<Problem<REAL>>
    readProb( const String& filename )
    {
+      BUGGER_TRACE_SCOPE( "io", "readProb" );
       MpsParser<REAL> parser;
 
       Problem<REAL> problem;
@@ -849,20 +845,10 @@ template <typename REAL>
 bool
 MpsParser<REAL>::parseFile( const String& filename )
 {
-   std::ifstream file( filename, std::ifstream::in );
    boost::iostreams::filtering_istream in;
 
-   if( !file )
+   if( !openInput( in, filename ) )
       return false;
-#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_ZLIB
-   if( boost::algorithm::ends_with( filename, ".gz" ) )
-      in.push( boost::iostreams::gzip_decompressor() );
-#endif
-#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_BZIP2
-   if( boost::algorithm::ends_with( filename, ".bz2" ) )
-      in.push( boost::iostreams::bzip2_decompressor() );
-#endif
-   in.push( file );
 
    return parse( in );
 }
@@ -26,12 +26,15 @@
 #define _BUGGER_IO_MPS_WRITER_HPP_
 
 #include "bugger/data/Problem.hpp"
-
-#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_ZLIB
-#include <boost/iostreams/filter/gzip.hpp>
-#endif
-#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_BZIP2
-#include <boost/iostreams/filter/bzip2.hpp>
+#include "bugger/io/Compression.hpp"
+#include "bugger/misc/Trace.hpp"
+#include "bugger/misc/fmt.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#ifdef BUGGER_TBB
+#include "bugger/misc/tbb.hpp"
 #endif
 
 
@@ -43,107 +46,243 @@ struct MpsWriter
 {
    static void
    writeProb( const String& filename, const Problem<REAL>& prob )
+   {
+      BUGGER_TRACE_SCOPE( "io", "writeProb" );
+      boost::iostreams::filtering_ostream out;
+      if( !openOutput( out, filename ) )
+         return;
+      writeProb( out, prob );
+   }
+
+   /// writes the problem uncompressed into the given stream, for example a
+   /// pipe to a solver process
+   ///
+   /// The sections are formatted in chunks of rows or columns into separate
+   /// buffers, in parallel if TBB is available, while a writer thread passes
+   /// the finished buffers in order to the stream so that compression overlaps
+   /// with formatting.
+   static void
+   writeProb( std::ostream& out, const Problem<REAL>& prob )
    {
       const ConstraintMatrix<REAL>& consmatrix = prob.getConstraintMatrix();
-      const Vec<String>& consnames = prob.getConstraintNames();
-      const Vec<String>& varnames = prob.getVariableNames();
-      const Vec<REAL>& lhs = consmatrix.getLeftHandSides();
-      const Vec<REAL>& rhs = consmatrix.getRightHandSides();
-      const Objective<REAL>& obj = prob.getObjective();
       const Vec<ColFlags>& col_flags = prob.getColFlags();
       const Vec<RowFlags>& row_flags = prob.getRowFlags();
 
-      std::ofstream file( filename, std::ofstream::out );
-      boost::iostreams::filtering_ostream out;
-#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_ZLIB
-      if( boost::algorithm::ends_with( filename, ".gz" ) )
-         out.push( boost::iostreams::gzip_compressor() );
-#endif
-#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_BZIP2
-      if( boost::algorithm::ends_with( filename, ".bz2" ) )
-         out.push( boost::iostreams::bzip2_compressor() );
-#endif
-      out.push( file );
-
-      int nrows = 0;
-      int ncols = 0;
-      int nintcols = 0;
-      int nnnz = 0;
+      Counts counts;
       for( int i = 0; i < consmatrix.getNRows(); ++i )
       {
          if( !row_flags[i].test(RowFlag::kRedundant) )
          {
-            ++nrows;
+            ++counts.nrows;
             auto data = consmatrix.getRowCoefficients(i);
             for( int j = 0; j < data.getLength(); ++j )
             {
                if( data.getValues()[j] != 0 )
                {
                   assert(!col_flags[data.getIndices()[j]].test(ColFlag::kFixed));
-                  ++nnnz;
+                  ++counts.nnnz;
                }
             }
          }
+         if( !row_flags[i].test( RowFlag::kLhsInf, RowFlag::kRhsInf,
+                                 RowFlag::kEquation, RowFlag::kRedundant ) )
+            counts.hasRangedRow = true;
       }
       for( int i = 0; i < consmatrix.getNCols(); ++i )
       {
          if( !col_flags[i].test(ColFlag::kFixed) )
          {
-            ++ncols;
+            ++counts.ncols;
             if( col_flags[i].test(ColFlag::kIntegral) )
-               ++nintcols;
+               ++counts.nintcols;
          }
       }
 
-      fmt::print( out, "*Instance {} reduced by delta debugging\n", prob.getName());
-      fmt::print( out, "*\tConstraints:         {} of original {}\n", nrows, consmatrix.getNRows() );
-      fmt::print( out, "*\tVariables:           {} of original {}\n", ncols, consmatrix.getNCols() );
-      fmt::print( out, "*\tInteger:             {} of original {}\n", nintcols, prob.getNumIntegralCols());
-      fmt::print( out, "*\tNonzeros:            {} of original {}\n", nnnz, consmatrix.getNnz() );
+      Vec<Chunk> chunks;
+      chunks.push_back( { Section::kHeader, 0, 0 } );
+      addChunks( chunks, Section::kRows, consmatrix.getNRows() );
+      addChunks( chunks, Section::kColumns, consmatrix.getNCols() );
+      if( prob.getNumIntegralCols() != 0 )
+         addChunks( chunks, Section::kIntegralColumns, consmatrix.getNCols() );
+      addChunks( chunks, Section::kRhs, consmatrix.getNRows() );
+      if( counts.hasRangedRow )
+         addChunks( chunks, Section::kRanges, consmatrix.getNRows() );
+      addChunks( chunks, Section::kBounds, consmatrix.getNCols() );
+
+      int nchunks = static_cast<int>( chunks.size() );
+      Vec<fmt::memory_buffer> buffers( nchunks );
+      Vec<uint8_t> finished( nchunks, false );
+      bool aborted = false;
+      std::mutex mutex;
+      std::condition_variable ready;
+
+      std::thread writer( [&]() {
+         for( int i = 0; i < nchunks; ++i )
+         {
+            {
+               std::unique_lock<std::mutex> lock( mutex );
+               ready.wait( lock, [&]() { return finished[i] || aborted; } );
+               if( aborted )
+                  return;
+            }
+            out.write( buffers[i].data(),
+                       static_cast<std::streamsize>( buffers[i].size() ) );
+            // release the memory of the written chunk
+            buffers[i] = fmt::memory_buffer();
+         }
+      } );
 
-      fmt::print( out, "*\n*\n");
+      auto format = [&]( int i ) {
+         formatChunk( buffers[i], chunks[i], prob, counts );
+         {
+            std::lock_guard<std::mutex> lock( mutex );
+            finished[i] = true;
+         }
+         ready.notify_one();
+      };
 
-      fmt::print( out, "NAME          {}\n", prob.getName() );
-      fmt::print( out, "OBJSENSE\n" );
-      fmt::print( out, obj.sense ? " MIN\n" : " MAX\n" );
-      fmt::print( out, "ROWS\n" );
-      fmt::print( out, " N  OBJ\n" );
-      bool hasRangedRow = false;
-      for( int i = 0; i < consmatrix.getNRows(); ++i )
+      try
+      {
+#ifdef BUGGER_TBB
+         tbb::parallel_for( tbb::blocked_range<int>( 0, nchunks, 1 ),
+                            [&]( const tbb::blocked_range<int>& r ) {
+                               for( int i = r.begin(); i != r.end(); ++i )
+                                  format( i );
+                            } );
+#else
+         for( int i = 0; i < nchunks; ++i )
+            format( i );
+#endif
+      }
+      catch( ... )
       {
-         //TODO this was original an assert so the nnz ana the ncols might not be correct anymore
-         if( consmatrix.isRowRedundant( i ) )
-            continue;
-         char type;
-
-         if( row_flags[i].test( RowFlag::kLhsInf ) &&
-             row_flags[i].test( RowFlag::kRhsInf ) )
-            type = 'N';
-         else if( row_flags[i].test( RowFlag::kRhsInf ) )
-            type = 'G';
-         else if( row_flags[i].test( RowFlag::kLhsInf ) )
-            type = 'L';
-         else
          {
-            if( !row_flags[i].test( RowFlag::kEquation ) )
-               hasRangedRow = true;
-            type = 'E';
+            std::lock_guard<std::mutex> lock( mutex );
+            aborted = true;
          }
-
-         fmt::print( out, " {}  {}\n", type, consnames[i] );
+         ready.notify_one();
+         writer.join();
+         throw;
       }
 
-      fmt::print( out, "COLUMNS\n" );
+      writer.join();
+   }
+
+private:
+   /// number of rows or columns formatted into one buffer
+   static constexpr int chunksize = 4096;
+
+   enum class Section
+   {
+      kHeader,
+      kRows,
+      kColumns,
+      kIntegralColumns,
+      kRhs,
+      kRanges,
+      kBounds
+   };
+
+   struct Chunk
+   {
+      Section section;
+      int begin;
+      int end;
+   };
+
+   struct Counts
+   {
+      int nrows = 0;
+      int ncols = 0;
+      int nintcols = 0;
+      int nnnz = 0;
+      bool hasRangedRow = false;
+   };
+
+   /// splits the index range of a section into chunks, at least one so that
+   /// the section is always opened and closed
+   static void
+   addChunks( Vec<Chunk>& chunks, Section section, int size )
+   {
+      int begin = 0;
+      do
+      {
+         int end = std::min( begin + chunksize, size );
+         chunks.push_back( { section, begin, end } );
+         begin = end;
+      } while( begin < size );
+   }
+
+   static void
+   formatChunk( fmt::memory_buffer& out, const Chunk& chunk,
+                const Problem<REAL>& prob, const Counts& counts )
+   {
+      const ConstraintMatrix<REAL>& consmatrix = prob.getConstraintMatrix();
+      const Vec<String>& consnames = prob.getConstraintNames();
+      const Vec<String>& varnames = prob.getVariableNames();
+      const Vec<REAL>& lhs = consmatrix.getLeftHandSides();
+      const Vec<REAL>& rhs = consmatrix.getRightHandSides();
+      const Objective<REAL>& obj = prob.getObjective();
+      const Vec<ColFlags>& col_flags = prob.getColFlags();
+      const Vec<RowFlags>& row_flags = prob.getRowFlags();
+      const Vec<REAL>& lower_bounds = prob.getLowerBounds();
+      const Vec<REAL>& upper_bounds = prob.getUpperBounds();
+      bool first = chunk.begin == 0;
 
-      int hasintegral = prob.getNumIntegralCols() != 0;
+      switch( chunk.section )
+      {
+      case Section::kHeader:
+         fmt::format_to( out, "*Instance {} reduced by delta debugging\n", prob.getName());
+         fmt::format_to( out, "*\tConstraints:         {} of original {}\n", counts.nrows, consmatrix.getNRows() );
+         fmt::format_to( out, "*\tVariables:           {} of original {}\n", counts.ncols, consmatrix.getNCols() );
+         fmt::format_to( out, "*\tInteger:             {} of original {}\n", counts.nintcols, prob.getNumIntegralCols());
+         fmt::format_to( out, "*\tNonzeros:            {} of original {}\n", counts.nnnz, consmatrix.getNnz() );
+
+         fmt::format_to( out, "*\n*\n");
+
+         fmt::format_to( out, "NAME          {}\n", prob.getName() );
+         fmt::format_to( out, "OBJSENSE\n" );
+         fmt::format_to( out, obj.sense ? " MIN\n" : " MAX\n" );
+         break;
+      case Section::kRows:
+         if( first )
+         {
+            fmt::format_to( out, "ROWS\n" );
+            fmt::format_to( out, " N  OBJ\n" );
+         }
+         for( int i = chunk.begin; i < chunk.end; ++i )
+         {
+            //TODO this was original an assert so the nnz ana the ncols might not be correct anymore
+            if( consmatrix.isRowRedundant( i ) )
+               continue;
+            char type;
+
+            if( row_flags[i].test( RowFlag::kLhsInf ) &&
+                row_flags[i].test( RowFlag::kRhsInf ) )
+               type = 'N';
+            else if( row_flags[i].test( RowFlag::kRhsInf ) )
+               type = 'G';
+            else if( row_flags[i].test( RowFlag::kLhsInf ) )
+               type = 'L';
+            else
+               type = 'E';
 
-      for( int integral = 0; integral <= hasintegral; ++integral )
+            fmt::format_to( out, " {}  {}\n", type, consnames[i] );
+         }
+         break;
+      case Section::kColumns:
+      case Section::kIntegralColumns:
       {
-         if( integral )
-            fmt::print( out,
-                        "    MARK0000  'MARKER'                 'INTORG'\n" );
+         bool integral = chunk.section == Section::kIntegralColumns;
+
+         if( first && !integral )
+            fmt::format_to( out, "COLUMNS\n" );
 
-         for( int i = 0; i < consmatrix.getNCols(); ++i )
+         if( first && integral )
+            fmt::format_to( out,
+                            "    MARK0000  'MARKER'                 'INTORG'\n" );
+
+         for( int i = chunk.begin; i < chunk.end; ++i )
          {
             if( col_flags[i].test( ColFlag::kInactive ) )
                continue;
@@ -156,7 +295,7 @@ struct MpsWriter
                 !col_flags[i].test( ColFlag::kFixed, ColFlag::kSubstituted ) );
 
             if( obj.coefficients[i] != 0 )
-               fmt::print( out, "    {:<9} OBJ       {:}\n", varnames[i], obj.coefficients[i] );
+               fmt::format_to( out, "    {:<9} OBJ       {:}\n", varnames[i], obj.coefficients[i] );
 
             SparseVectorView<REAL> column =
                 consmatrix.getColumnCoefficients( i );
@@ -174,52 +313,51 @@ struct MpsWriter
                   continue;
 
                // normal row
-               fmt::print( out, "    {:<9} {:<9} {:}\n", varnames[i], consnames[r], colvals[j] );
+               fmt::format_to( out, "    {:<9} {:<9} {:}\n", varnames[i], consnames[r], colvals[j] );
             }
          }
 
-         if( integral )
-            fmt::print( out,
-                        "    MARK0000  'MARKER'                 'INTEND'\n" );
+         if( chunk.end == consmatrix.getNCols() && integral )
+            fmt::format_to( out,
+                            "    MARK0000  'MARKER'                 'INTEND'\n" );
+         break;
       }
+      case Section::kRhs:
+         if( first )
+         {
+            fmt::format_to( out, "RHS\n" );
 
-      const Vec<REAL>& lower_bounds = prob.getLowerBounds();
-      const Vec<REAL>& upper_bounds = prob.getUpperBounds();
-
-      fmt::print( out, "RHS\n" );
-
-      if( obj.offset != 0 )
-      {
-         if( obj.offset != 0 )
-            fmt::print( out, "    B         {:<9} {:}\n", "OBJ", -obj.offset );
-      }
+            if( obj.offset != 0 )
+               fmt::format_to( out, "    B         {:<9} {:}\n", "OBJ", -obj.offset );
+         }
 
-      for( int i = 0; i < consmatrix.getNRows(); ++i )
-      {
-         // discard redundant rows when writing problem
-         if( consmatrix.isRowRedundant( i ) )
-            continue;
+         for( int i = chunk.begin; i < chunk.end; ++i )
+         {
+            // discard redundant rows when writing problem
+            if( consmatrix.isRowRedundant( i ) )
+               continue;
 
-         if( row_flags[i].test( RowFlag::kLhsInf ) &&
-             row_flags[i].test( RowFlag::kRhsInf ) )
-            continue;
+            if( row_flags[i].test( RowFlag::kLhsInf ) &&
+                row_flags[i].test( RowFlag::kRhsInf ) )
+               continue;
 
-         if( row_flags[i].test( RowFlag::kLhsInf ) )
-         {
-            if( rhs[i] != 0 )
-               fmt::print( out, "    B         {:<9} {:}\n", consnames[i], rhs[i] );
-         }
-         else
-         {
-            if( lhs[i] != 0 )
-               fmt::print( out, "    B         {:<9} {:}\n", consnames[i], lhs[i] );
+            if( row_flags[i].test( RowFlag::kLhsInf ) )
+            {
+               if( rhs[i] != 0 )
+                  fmt::format_to( out, "    B         {:<9} {:}\n", consnames[i], rhs[i] );
+            }
+            else
+            {
+               if( lhs[i] != 0 )
+                  fmt::format_to( out, "    B         {:<9} {:}\n", consnames[i], lhs[i] );
+            }
          }
-      }
+         break;
+      case Section::kRanges:
+         if( first )
+            fmt::format_to( out, "RANGES\n" );
 
-      if( hasRangedRow )
-      {
-         fmt::print( out, "RANGES\n" );
-         for( int i = 0; i < consmatrix.getNRows(); ++i )
+         for( int i = chunk.begin; i < chunk.end; ++i )
          {
             if( row_flags[i].test( RowFlag::kLhsInf, RowFlag::kRhsInf,
                                    RowFlag::kEquation, RowFlag::kRedundant ) )
@@ -228,38 +366,43 @@ struct MpsWriter
             REAL rangeval = rhs[i] - lhs[i];
 
             if( rangeval != 0 )
-               fmt::print( out, "    B         {:<9} {:}\n", consnames[i], rangeval );
+               fmt::format_to( out, "    B         {:<9} {:}\n", consnames[i], rangeval );
          }
-      }
+         break;
+      case Section::kBounds:
+         if( first )
+            fmt::format_to( out, "BOUNDS\n" );
 
-      fmt::print( out, "BOUNDS\n" );
-
-      for( int i = 0; i < consmatrix.getNCols(); ++i )
-      {
-         if( col_flags[i].test( ColFlag::kInactive ) )
-            continue;
-
-         if( !col_flags[i].test( ColFlag::kLbInf ) &&
-             !col_flags[i].test( ColFlag::kUbInf ) &&
-             lower_bounds[i] == upper_bounds[i] )
-            fmt::print( out, " FX BND       {:<9} {:}\n", varnames[i], lower_bounds[i] );
-         else
+         for( int i = chunk.begin; i < chunk.end; ++i )
          {
-            if( col_flags[i].test( ColFlag::kLbInf ) || lower_bounds[i] != 0 )
+            if( col_flags[i].test( ColFlag::kInactive ) )
+               continue;
+
+            if( !col_flags[i].test( ColFlag::kLbInf ) &&
+                !col_flags[i].test( ColFlag::kUbInf ) &&
+                lower_bounds[i] == upper_bounds[i] )
+               fmt::format_to( out, " FX BND       {:<9} {:}\n", varnames[i], lower_bounds[i] );
+            else
             {
-               if( col_flags[i].test( ColFlag::kLbInf ) )
-                  fmt::print( out, " MI BND       {:}\n", varnames[i] );
+               if( col_flags[i].test( ColFlag::kLbInf ) || lower_bounds[i] != 0 )
+               {
+                  if( col_flags[i].test( ColFlag::kLbInf ) )
+                     fmt::format_to( out, " MI BND       {:}\n", varnames[i] );
+                  else
+                     fmt::format_to( out, " LO BND       {:<9} {:}\n", varnames[i], lower_bounds[i] );
+               }
+
+               if( !col_flags[i].test( ColFlag::kUbInf ) )
+                  fmt::format_to( out, " UP BND       {:<9} {:}\n", varnames[i], upper_bounds[i] );
                else
-                  fmt::print( out, " LO BND       {:<9} {:}\n", varnames[i], lower_bounds[i] );
+                  fmt::format_to( out, " PL BND       {:}\n", varnames[i] );
             }
-
-            if( !col_flags[i].test( ColFlag::kUbInf ) )
-               fmt::print( out, " UP BND       {:<9} {:}\n", varnames[i], upper_bounds[i] );
-            else
-               fmt::print( out, " PL BND       {:}\n", varnames[i] );
          }
+
+         if( chunk.end == consmatrix.getNCols() )
+            fmt::format_to( out, "ENDATA\n" );
+         break;
       }
-      fmt::print( out, "ENDATA\n" );
    }
 };
 
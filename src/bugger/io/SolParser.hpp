@@ -26,15 +26,10 @@
 #define _BUGGER_IO_SOL_PARSER_HPP_
 
 #include "bugger/data/Solution.hpp"
+#include "bugger/io/Compression.hpp"
 #include "bugger/misc/Hash.hpp"
 #include "bugger/misc/Num.hpp"
-
-#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_ZLIB
-#include <boost/iostreams/filter/gzip.hpp>
-#endif
-#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_BZIP2
-#include <boost/iostreams/filter/bzip2.hpp>
-#endif
+#include "bugger/misc/Trace.hpp"
 
 
 namespace bugger
@@ -46,22 +41,13 @@ struct SolParser
    static boost::optional<Solution<REAL>>
    readSol( const String& filename, const Vec<String>& colnames )
    {
-      std::ifstream file( filename, std::ifstream::in );
+      BUGGER_TRACE_SCOPE( "io", "readSol" );
       boost::iostreams::filtering_istream in;
 
-      if( !file )
+      if( !openInput( in, filename ) )
          return boost::none;
 
       Solution<REAL> sol { };
-#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_ZLIB
-      if( boost::algorithm::ends_with( filename, ".gz" ) )
-         in.push( boost::iostreams::gzip_decompressor() );
-#endif
-#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_BZIP2
-      if( boost::algorithm::ends_with( filename, ".bz2" ) )
-      in.push( boost::iostreams::bzip2_decompressor() );
-#endif
-      in.push( file );
 
       HashMap<String, int> nameToCol;
 
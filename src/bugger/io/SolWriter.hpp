@@ -26,13 +26,8 @@
 #define _BUGGER_IO_SOL_WRITER_HPP_
 
 #include "bugger/data/Solution.hpp"
-
-#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_ZLIB
-#include <boost/iostreams/filter/gzip.hpp>
-#endif
-#ifdef BUGGER_USE_BOOST_IOSTREAMS_WITH_BZIP2
-#include <boost/iostreams/filter/bzip2.hpp>
-#endif
+#include "bugger/io/Compression.hpp"
+#include "bugger/misc/Trace.hpp"
 
 
 namespace bugger
@@ -44,19 +39,12 @@ struct SolWriter
    static void
    writeSol( const String& filename, const Problem<REAL>& prob, const Solution<REAL>& sol )
    {
+      BUGGER_TRACE_SCOPE( "io", "writeSol" );
       if( sol.status != SolutionStatus::kFeasible )
          return;
-      std::ofstream file( filename, std::ofstream::out );
       boost::iostreams::filtering_ostream out;
-#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_ZLIB
-      if( boost::algorithm::ends_with( filename, ".gz" ) )
-         out.push( boost::iostreams::gzip_compressor() );
-#endif
-#ifdef PAPILO_USE_BOOST_IOSTREAMS_WITH_BZIP2
-      if( boost::algorithm::ends_with( filename, ".bz2" ) )
-         out.push( boost::iostreams::bzip2_compressor() );
-#endif
-      out.push( file );
+      if( !openOutput( out, filename ) )
+         return;
       fmt::print( out, "{:<35} {:}\n", "=obj=", prob.getPrimalObjective(sol) );
       for( int i = 0; i < prob.getNCols(); ++i )
       {
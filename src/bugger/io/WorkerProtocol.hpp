@@ -0,0 +1,423 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BUGGER_IO_WORKERPROTOCOL_HPP__
+#define __BUGGER_IO_WORKERPROTOCOL_HPP__
+
+#include "bugger/Config.hpp"
+#include "bugger/data/ProblemDelta.hpp"
+#include "bugger/data/SolverSettings.hpp"
+#include "bugger/interfaces/SolverStatus.hpp"
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/asio.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <sstream>
+#include <typeinfo>
+
+
+namespace bugger
+{
+   /// types of messages exchanged between bugger and its solve workers
+   enum class WorkerMessage : std::uint32_t
+   {
+
+      /// identification sent by both sides when connecting
+      kHello = 1,
+
+      /// base problem and reference solution which deltas of subsequent jobs refer to
+      kBase = 2,
+
+      /// solve request
+      kJob = 3,
+
+      /// solve response
+      kResult = 4,
+
+      /// sign of life sent by a worker while solving
+      kHeartbeat = 5,
+
+      /// termination of the session
+      kShutdown = 6,
+
+   };
+
+   /// greeting of a session to make sure that both sides run the same bugger build
+   struct WorkerHello
+   {
+      String signature { };
+      double heartbeat = 0.0;
+
+      template <typename REAL>
+      static String
+      get_signature( )
+      {
+         return fmt::format("MIP-DD {}.{}.{} {} {}", BUGGER_VERSION_MAJOR, BUGGER_VERSION_MINOR,
+                            BUGGER_VERSION_PATCH, typeid(REAL).name( ), sizeof(REAL));
+      }
+
+      template <typename Archive>
+      void
+      serialize(Archive& ar, const unsigned int version)
+      {
+         ar& signature;
+         ar& heartbeat;
+      }
+   };
+
+   /// base problem and reference solution
+   template <typename REAL>
+   struct WorkerBase
+   {
+      long long id = -1;
+      Problem<REAL> problem { };
+      Solution<REAL> solution { };
+
+      template <typename Archive>
+      void
+      serialize(Archive& ar, const unsigned int version)
+      {
+         ar& id;
+         ar& problem;
+         ar& solution;
+      }
+   };
+
+   /// solve request on the base problem modified by the delta
+   template <typename REAL>
+   struct WorkerJob
+   {
+      long long id = -1;
+      long long base = -1;
+      SolverSettings settings { };
+      ProblemDelta<REAL> delta { };
+      Vec<int> passcodes { };
+
+      template <typename Archive>
+      void
+      serialize(Archive& ar, const unsigned int version)
+      {
+         ar& id;
+         ar& base;
+         ar& settings;
+         ar& delta;
+         ar& passcodes;
+      }
+   };
+
+   /// solve response holding the settings adjusted by the solver
+   struct WorkerResult
+   {
+      long long id = -1;
+      bool valid = false;
+      char retcode = 0;
+      SolverStatus status = SolverStatus::kUnknown;
+      long long effort = -1;
+      double time = -1.0;
+      String fingerprint { };
+      SolverSettings settings { };
+
+      template <typename Archive>
+      void
+      serialize(Archive& ar, const unsigned int version)
+      {
+         ar& id;
+         ar& valid;
+         ar& retcode;
+         ar& status;
+         ar& effort;
+         ar& time;
+         ar& fingerprint;
+         ar& settings;
+      }
+   };
+
+   /**
+    * framed message connection between bugger and a solve worker over a local or tcp stream socket
+    * addresses are given as unix:PATH, tcp:HOST:PORT, or HOST:PORT
+    * messages are exchanged in host byte order and binary archives, so all sides have to share the same build
+    */
+   class WorkerChannel
+   {
+   private:
+
+      struct Header
+      {
+         std::uint32_t type;
+         std::uint32_t magic;
+         std::uint64_t size;
+      };
+
+      static constexpr std::uint32_t MAGIC = 0x4d495044;
+
+      // bound on the announced payload size so that a corrupt header cannot force a huge allocation
+      static constexpr std::uint64_t MAXSIZE = std::uint64_t(1) << 32;
+
+      using Protocol = boost::asio::generic::stream_protocol;
+
+      boost::asio::io_context context { };
+      Protocol::socket socket { context };
+      std::unique_ptr<boost::asio::basic_socket_acceptor<Protocol>> acceptor { };
+
+   public:
+
+      WorkerChannel( ) = default;
+
+      WorkerChannel(const WorkerChannel&) = delete;
+
+      WorkerChannel&
+      operator=(const WorkerChannel&) = delete;
+
+      ~WorkerChannel( )
+      {
+         close( );
+         if( acceptor )
+            acceptor->close( );
+      }
+
+      /**
+       * connects to the worker listening on address
+       * @param address
+       * @param timeout seconds to wait or negative for no limit
+       * @return whether the connection is established
+       */
+      bool
+      connect(const String& address, double timeout)
+      {
+         close( );
+         Vec<Protocol::endpoint> endpoints = resolve(address);
+         for( const auto& endpoint: endpoints )
+         {
+            socket = Protocol::socket(context);
+            if( perform([&](const std::function<void(const boost::system::error_code&, std::size_t)>& handler) {
+                  socket.async_connect(endpoint, [handler](const boost::system::error_code& error) { handler(error, 0); });
+               }, timeout) )
+               return true;
+         }
+         return false;
+      }
+
+      /**
+       * opens address for incoming connections
+       * @param address
+       * @return whether the address could be bound
+       */
+      bool
+      listen(const String& address)
+      {
+         Vec<Protocol::endpoint> endpoints = resolve(address, true);
+         for( const auto& endpoint: endpoints )
+         {
+            boost::system::error_code error;
+            acceptor.reset(new boost::asio::basic_socket_acceptor<Protocol>(context));
+            acceptor->open(endpoint.protocol( ), error);
+            if( !error && endpoint.protocol( ).family( ) != AF_UNIX )
+               acceptor->set_option(boost::asio::socket_base::reuse_address(true), error);
+            if( !error )
+               acceptor->bind(endpoint, error);
+            if( !error )
+               acceptor->listen(boost::asio::socket_base::max_listen_connections, error);
+            if( !error )
+               return true;
+         }
+         acceptor.reset( );
+         return false;
+      }
+
+      /**
+       * waits for the next incoming connection on the listened address
+       * @return whether a connection is established
+       */
+      bool
+      accept( )
+      {
+         close( );
+         if( !acceptor )
+            return false;
+         socket = Protocol::socket(context);
+         boost::system::error_code error;
+         acceptor->accept(socket, error);
+         return !error;
+      }
+
+      bool
+      is_open( ) const
+      {
+         return socket.is_open( );
+      }
+
+      void
+      close( )
+      {
+         boost::system::error_code error;
+         if( socket.is_open( ) )
+         {
+            socket.shutdown(Protocol::socket::shutdown_both, error);
+            socket.close(error);
+         }
+      }
+
+      /**
+       * sends message of given type
+       * @param type
+       * @param payload
+       * @param timeout seconds to wait or negative for no limit
+       * @return whether the message is sent
+       */
+      bool
+      send(const WorkerMessage& type, const String& payload, double timeout = -1.0)
+      {
+         Header header { static_cast<std::uint32_t>(type), MAGIC, static_cast<std::uint64_t>(payload.size( )) };
+         std::array<boost::asio::const_buffer, 2> buffers { boost::asio::buffer(&header, sizeof(header)),
+                                                            boost::asio::buffer(payload) };
+         return perform([&](const std::function<void(const boost::system::error_code&, std::size_t)>& handler) {
+               boost::asio::async_write(socket, buffers, handler);
+            }, timeout);
+      }
+
+      /**
+       * receives next message
+       * @param type
+       * @param payload
+       * @param timeout seconds to wait or negative for no limit
+       * @return whether a valid message is received, where the connection is closed on payloads exceeding MAXSIZE
+       */
+      bool
+      receive(WorkerMessage& type, String& payload, double timeout = -1.0)
+      {
+         Header header { };
+         if( !perform([&](const std::function<void(const boost::system::error_code&, std::size_t)>& handler) {
+               boost::asio::async_read(socket, boost::asio::buffer(&header, sizeof(header)), handler);
+            }, timeout) || header.magic != MAGIC )
+            return false;
+         if( header.size > MAXSIZE )
+         {
+            // the stream cannot be resynchronized behind a corrupt frame
+            close( );
+            return false;
+         }
+         type = static_cast<WorkerMessage>(header.type);
+         payload.resize(header.size);
+         return header.size == 0 || perform([&](const std::function<void(const boost::system::error_code&, std::size_t)>& handler) {
+               boost::asio::async_read(socket, boost::asio::buffer(&payload[ 0 ], payload.size( )), handler);
+            }, timeout);
+      }
+
+      template <typename T>
+      static String
+      pack(const T& object)
+      {
+         std::ostringstream stream { };
+         {
+            boost::archive::binary_oarchive archive(stream);
+            archive << object;
+         }
+         return stream.str( );
+      }
+
+      template <typename T>
+      static bool
+      unpack(const String& payload, T& object)
+      {
+         try
+         {
+            std::istringstream stream(payload);
+            boost::archive::binary_iarchive archive(stream);
+            archive >> object;
+            return true;
+         }
+         catch( const std::exception& )
+         {
+            return false;
+         }
+      }
+
+   private:
+
+      /// runs the asynchronous operation until its completion or the timeout which closes the connection
+      template <typename OPERATION>
+      bool
+      perform(OPERATION&& operation, double timeout)
+      {
+         bool done = false;
+         boost::system::error_code result { };
+         operation([&](const boost::system::error_code& error, std::size_t) {
+            result = error;
+            done = true;
+         });
+         context.restart( );
+         if( timeout < 0.0 )
+            context.run( );
+         else
+            context.run_for(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::duration<double>(timeout)));
+         if( !done )
+         {
+            close( );
+            context.restart( );
+            context.run( );
+            return false;
+         }
+         return !result;
+      }
+
+      Vec<Protocol::endpoint>
+      resolve(const String& address, bool passive = false)
+      {
+         Vec<Protocol::endpoint> endpoints { };
+         if( address.compare(0, 5, "unix:") == 0 )
+         {
+            if( passive )
+               std::remove(address.substr(5).c_str( ));
+            endpoints.emplace_back(boost::asio::local::stream_protocol::endpoint(address.substr(5)));
+            return endpoints;
+         }
+         String location = address.compare(0, 4, "tcp:") == 0 ? address.substr(4) : address;
+         std::size_t pos = location.rfind(':');
+         if( pos == String::npos )
+            return endpoints;
+         String host = location.substr(0, pos);
+         if( host.size( ) >= 2 && host.front( ) == '[' && host.back( ) == ']' )
+            host = host.substr(1, host.size( ) - 2);
+         boost::system::error_code error;
+         boost::asio::ip::tcp::resolver resolver(context);
+         auto results = resolver.resolve(host, location.substr(pos + 1), passive
+                                         ? boost::asio::ip::tcp::resolver::passive | boost::asio::ip::tcp::resolver::address_configured
+                                         : boost::asio::ip::tcp::resolver::address_configured, error);
+         if( !error )
+            for( const auto& entry: results )
+               endpoints.emplace_back(entry.endpoint( ));
+         return endpoints;
+      }
+   };
+
+} // namespace bugger
+
+#endif
@@ -25,20 +25,354 @@
 #ifndef _BUGGER_MISC_ALLOC_HPP_
 #define _BUGGER_MISC_ALLOC_HPP_
 
+#include "bugger/Config.hpp"
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <new>
 
 namespace bugger
 {
 
-template <typename T, int = 0>
+/// size-class pools of the calling thread, which recycle freed blocks of up to 64 KiB instead of returning them to the
+/// heap; blocks may be freed by any thread and are handed back to the heap when the thread exits
+class PoolResource
+{
+   struct Node
+   {
+      Node* next;
+   };
+
+   static constexpr int NCLASSES = 13;
+   static constexpr std::size_t MINSIZE = 16;
+
+   // trivially destructible so that blocks freed after the exit cleanup still find a valid state
+   struct State
+   {
+      Node* heads[NCLASSES];
+      bool released;
+   };
+
+   struct Cleanup
+   {
+      ~Cleanup( )
+      {
+         trim( );
+         state( ).released = true;
+      }
+   };
+
+   static State&
+   state( )
+   {
+      static thread_local State current{};
+      return current;
+   }
+
+   static int
+   getClass( std::size_t bytes )
+   {
+      int sizeclass = 0;
+      for( std::size_t size = MINSIZE; size < bytes; size <<= 1 )
+         ++sizeclass;
+      return sizeclass < NCLASSES ? sizeclass : -1;
+   }
+
+ public:
+   static void*
+   allocate( std::size_t bytes )
+   {
+      int sizeclass = getClass( bytes );
+      if( sizeclass < 0 )
+         return ::operator new( bytes );
+      State& current = state( );
+      Node* node = current.heads[sizeclass];
+      if( node == nullptr )
+         return ::operator new( MINSIZE << sizeclass );
+      current.heads[sizeclass] = node->next;
+      return node;
+   }
+
+   static void
+   deallocate( void* pointer, std::size_t bytes )
+   {
+      int sizeclass = getClass( bytes );
+      State& current = state( );
+      if( sizeclass < 0 || current.released )
+      {
+         ::operator delete( pointer );
+         return;
+      }
+      static thread_local Cleanup cleanup;
+      (void) cleanup;
+      Node* node = static_cast<Node*>( pointer );
+      node->next = current.heads[sizeclass];
+      current.heads[sizeclass] = node;
+   }
+
+   /// hands the blocks cached by the calling thread back to the heap, for example to meet a memory limit
+   static void
+   trim( )
+   {
+      State& current = state( );
+      for( auto& head : current.heads )
+      {
+         while( head != nullptr )
+         {
+            Node* node = head;
+            head = node->next;
+            ::operator delete( node );
+         }
+      }
+   }
+};
+
+/// monotonic arena of the calling thread for scratch data, which hands out memory by bumping a pointer, ignores
+/// deallocations and is rewound as a whole by reset( ) once none of its data is in use anymore
+class Arena
+{
+   struct Chunk
+   {
+      Chunk* next;
+      std::size_t size;
+   };
+
+   static constexpr std::size_t CHUNKSIZE = 1 << 16;
+
+   Chunk* chunks = nullptr;
+   char* pointer = nullptr;
+   char* end = nullptr;
+   std::size_t used = 0;
+   std::size_t peak = 0;
+
+   void
+   addChunk( std::size_t bytes )
+   {
+      std::size_t size = chunks == nullptr ? CHUNKSIZE : 2 * chunks->size;
+      while( size < bytes + sizeof( Chunk ) + alignof( std::max_align_t ) )
+         size *= 2;
+      Chunk* chunk = static_cast<Chunk*>( ::operator new( size ) );
+      chunk->next = chunks;
+      chunk->size = size;
+      chunks = chunk;
+      pointer = reinterpret_cast<char*>( chunk + 1 );
+      end = reinterpret_cast<char*>( chunk ) + size;
+   }
+
+   void
+   release( )
+   {
+      while( chunks != nullptr )
+      {
+         Chunk* chunk = chunks;
+         chunks = chunk->next;
+         ::operator delete( chunk );
+      }
+      pointer = nullptr;
+      end = nullptr;
+   }
+
+ public:
+   Arena() = default;
+
+   Arena( const Arena& ) = delete;
+
+   Arena&
+   operator=( const Arena& ) = delete;
+
+   ~Arena() { release( ); }
+
+   static Arena&
+   local( )
+   {
+      static thread_local Arena arena;
+      return arena;
+   }
+
+   void*
+   allocate( std::size_t bytes, std::size_t alignment )
+   {
+      std::size_t padding = ( alignment - reinterpret_cast<std::uintptr_t>( pointer ) % alignment ) % alignment;
+      if( pointer == nullptr || padding + bytes > std::size_t( end - pointer ) )
+      {
+         addChunk( bytes + alignment );
+         padding = ( alignment - reinterpret_cast<std::uintptr_t>( pointer ) % alignment ) % alignment;
+      }
+      void* block = pointer + padding;
+      pointer += padding + bytes;
+      used += padding + bytes;
+      if( peak < used )
+         peak = used;
+      return block;
+   }
+
+   /// invalidates all scratch data of the thread and keeps a single chunk holding the peak usage since the last
+   /// reset so that a recurring workload is served without further heap allocations
+   void
+   reset( )
+   {
+      if( chunks != nullptr && ( chunks->next != nullptr || chunks->size < peak + sizeof( Chunk ) ) )
+      {
+         std::size_t bytes = peak;
+         release( );
+         addChunk( bytes );
+      }
+      else if( chunks != nullptr )
+         pointer = reinterpret_cast<char*>( chunks + 1 );
+      used = 0;
+      peak = 0;
+   }
+
+   /// releases all chunks of the thread if no scratch data is in use, for example to meet a memory limit
+   void
+   trim( )
+   {
+      if( used == 0 )
+      {
+         release( );
+         peak = 0;
+      }
+   }
+
+   std::size_t
+   getUsed( ) const
+   {
+      return used;
+   }
+
+   /// bytes held by the chunks of the thread
+   std::size_t
+   getCapacity( ) const
+   {
+      std::size_t capacity = 0;
+      for( const Chunk* chunk = chunks; chunk != nullptr; chunk = chunk->next )
+         capacity += chunk->size;
+      return capacity;
+   }
+};
+
+template <typename T>
+struct PoolAllocator
+{
+   using value_type = T;
+
+   PoolAllocator() = default;
+
+   template <typename U>
+   PoolAllocator( const PoolAllocator<U>& )
+   {
+   }
+
+   T*
+   allocate( std::size_t n )
+   {
+      static_assert( alignof( T ) <= alignof( std::max_align_t ),
+                     "over-aligned types are not supported by the pools" );
+      return static_cast<T*>( PoolResource::allocate( n * sizeof( T ) ) );
+   }
+
+   void
+   deallocate( T* p, std::size_t n )
+   {
+      PoolResource::deallocate( p, n * sizeof( T ) );
+   }
+
+   template <typename U>
+   bool
+   operator==( const PoolAllocator<U>& ) const
+   {
+      return true;
+   }
+
+   template <typename U>
+   bool
+   operator!=( const PoolAllocator<U>& ) const
+   {
+      return false;
+   }
+};
+
+/// allocator of the arena of the calling thread, so scratch containers must not outlive the current batch
+template <typename T>
+struct ArenaAllocator
+{
+   using value_type = T;
+
+   ArenaAllocator() = default;
+
+   template <typename U>
+   ArenaAllocator( const ArenaAllocator<U>& )
+   {
+   }
+
+   T*
+   allocate( std::size_t n )
+   {
+      return static_cast<T*>( Arena::local( ).allocate( n * sizeof( T ), alignof( T ) ) );
+   }
+
+   void
+   deallocate( T*, std::size_t )
+   {
+   }
+
+   template <typename U>
+   bool
+   operator==( const ArenaAllocator<U>& ) const
+   {
+      return true;
+   }
+
+   template <typename U>
+   bool
+   operator!=( const ArenaAllocator<U>& ) const
+   {
+      return false;
+   }
+};
+
+/// purposes of allocations to select the allocator by
+enum AllocatorPurpose
+{
+   /// data that persists beyond a single batch
+   kPersistent = 0,
+   /// scratch data of a single batch, which is released when the arena is reset at the next batch boundary
+   kScratch = 1
+};
+
+template <typename T, int = kPersistent>
 struct AllocatorTraits
 {
+#ifdef BUGGER_USE_POOL_ALLOCATOR
+   using type = PoolAllocator<T>;
+#else
    using type = std::allocator<T>;
+#endif
+};
+
+/// strings keep the standard allocator to interoperate with std::string of the libraries
+template <>
+struct AllocatorTraits<char, kPersistent>
+{
+   using type = std::allocator<char>;
+};
+
+template <typename T>
+struct AllocatorTraits<T, kScratch>
+{
+#ifdef BUGGER_USE_ARENA_ALLOCATOR
+   using type = ArenaAllocator<T>;
+#else
+   using type = typename AllocatorTraits<T, kPersistent>::type;
+#endif
 };
 
 template <typename T>
 using Allocator = typename AllocatorTraits<T>::type;
 
+template <typename T>
+using ScratchAllocator = typename AllocatorTraits<T, kScratch>::type;
+
 } // namespace bugger
 
 #endif
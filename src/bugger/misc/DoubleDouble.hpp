@@ -0,0 +1,600 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _BUGGER_MISC_DOUBLEDOUBLE_HPP_
+#define _BUGGER_MISC_DOUBLEDOUBLE_HPP_
+
+#include "bugger/misc/fmt.hpp"
+#include "bugger/misc/String.hpp"
+#include <boost/multiprecision/cpp_bin_float.hpp>
+#include <boost/multiprecision/cpp_dec_float.hpp>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace bugger
+{
+
+/**
+ * unevaluated sum of two doubles with about 106 bits of mantissa
+ * arithmetic follows the accurate algorithms of the QD library by Hida, Li, and Bailey so that it offers nearly the
+ * precision of quad at a fraction of the cost of the software emulated quad types, while the exponent range remains
+ * the one of double
+ */
+class DoubleDouble
+{
+   double hi;
+   double lo;
+
+   static void
+   two_sum( double a, double b, double& s, double& err )
+   {
+      s = a + b;
+      double bb = s - a;
+      err = ( a - ( s - bb ) ) + ( b - bb );
+   }
+
+   static void
+   quick_two_sum( double a, double b, double& s, double& err )
+   {
+      s = a + b;
+      err = b - ( s - a );
+   }
+
+#ifndef FP_FAST_FMA
+   static void
+   split( double a, double& high, double& low )
+   {
+      // splitting factor 2^27 + 1 of Dekker
+      double temp = 134217729.0 * a;
+      high = temp - ( temp - a );
+      low = a - high;
+   }
+#endif
+
+   static void
+   two_prod( double a, double b, double& p, double& err )
+   {
+      p = a * b;
+#ifdef FP_FAST_FMA
+      err = std::fma( a, b, -p );
+#else
+      // fma is emulated in software without hardware support
+      double a_hi;
+      double a_lo;
+      double b_hi;
+      double b_lo;
+      split( a, a_hi, a_lo );
+      split( b, b_hi, b_lo );
+      err = ( ( a_hi * b_hi - p ) + a_hi * b_lo + a_lo * b_hi ) + a_lo * b_lo;
+#endif
+   }
+
+ public:
+   constexpr DoubleDouble() : hi( 0.0 ), lo( 0.0 ) {}
+
+   /**
+    * constructs the normalized sum of two doubles
+    * @param _hi
+    * @param _lo
+    */
+   DoubleDouble( double _hi, double _lo )
+   {
+      if( std::isfinite( _hi ) )
+         quick_two_sum( _hi, _lo, hi, lo );
+      else
+      {
+         hi = _hi;
+         lo = 0.0;
+      }
+   }
+
+   template <typename T,
+             typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+   DoubleDouble( T value ) : hi( (double)value ), lo( 0.0 )
+   {
+      if( std::isfinite( hi ) )
+         lo = (double)( value - (T)hi );
+   }
+
+   template <typename T,
+             typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+   DoubleDouble( T value ) : hi( 0.0 ), lo( 0.0 )
+   {
+      // split wide integers into parts exactly representable as double
+      if( sizeof( T ) > 4 )
+      {
+         T high = value / ( (T)1 << 32 );
+         *this = DoubleDouble( (double)high * 4294967296.0, (double)( value - high * ( (T)1 << 32 ) ) );
+      }
+      else
+         hi = (double)value;
+   }
+
+   template <typename Backend, boost::multiprecision::expression_template_option ET>
+   explicit DoubleDouble( const boost::multiprecision::number<Backend, ET>& value )
+       : hi( value.template convert_to<double>() ), lo( 0.0 )
+   {
+      // the conversion to double need not round correctly so that the parts are normalized
+      if( std::isfinite( hi ) )
+         *this = DoubleDouble( hi, boost::multiprecision::number<Backend, ET>( value - hi ).template convert_to<double>() );
+   }
+
+   /// nonzero like a double, which truncation toward zero would miss for
+   /// fractions
+   explicit operator bool() const { return hi != 0.0; }
+
+   template <typename T,
+             typename std::enable_if<std::is_arithmetic<T>::value &&
+                                         !std::is_same<T, bool>::value,
+                                     int>::type = 0>
+   explicit operator T() const
+   {
+      if( std::is_integral<T>::value )
+      {
+         DoubleDouble integer = hi < 0.0 ? ceil( *this ) : floor( *this );
+         return (T)integer.hi + (T)integer.lo;
+      }
+      return (T)hi + (T)lo;
+   }
+
+   template <typename Backend, boost::multiprecision::expression_template_option ET>
+   explicit operator boost::multiprecision::number<Backend, ET>() const
+   {
+      return boost::multiprecision::number<Backend, ET>( hi ) + boost::multiprecision::number<Backend, ET>( lo );
+   }
+
+   double
+   getHi() const
+   {
+      return hi;
+   }
+
+   double
+   getLo() const
+   {
+      return lo;
+   }
+
+   template <typename Archive>
+   void
+   serialize( Archive& ar, const unsigned int version )
+   {
+      ar& hi;
+      ar& lo;
+   }
+
+   DoubleDouble
+   operator-() const
+   {
+      DoubleDouble result;
+      result.hi = -hi;
+      result.lo = -lo;
+      return result;
+   }
+
+   DoubleDouble
+   operator+() const
+   {
+      return *this;
+   }
+
+   friend DoubleDouble
+   operator+( const DoubleDouble& a, const DoubleDouble& b )
+   {
+      double s1;
+      double s2;
+      double t1;
+      double t2;
+      two_sum( a.hi, b.hi, s1, s2 );
+      if( !std::isfinite( s1 ) )
+         return DoubleDouble( s1, 0.0 );
+      two_sum( a.lo, b.lo, t1, t2 );
+      s2 += t1;
+      quick_two_sum( s1, s2, s1, s2 );
+      s2 += t2;
+      return DoubleDouble( s1, s2 );
+   }
+
+   friend DoubleDouble
+   operator-( const DoubleDouble& a, const DoubleDouble& b )
+   {
+      return a + -b;
+   }
+
+   friend DoubleDouble
+   operator*( const DoubleDouble& a, const DoubleDouble& b )
+   {
+      double p1;
+      double p2;
+      two_prod( a.hi, b.hi, p1, p2 );
+      if( !std::isfinite( p1 ) )
+         return DoubleDouble( p1, 0.0 );
+      p2 += a.hi * b.lo + a.lo * b.hi;
+      return DoubleDouble( p1, p2 );
+   }
+
+   friend DoubleDouble
+   operator/( const DoubleDouble& a, const DoubleDouble& b )
+   {
+      double q1 = a.hi / b.hi;
+      if( !std::isfinite( q1 ) || !std::isfinite( b.hi ) )
+         return DoubleDouble( q1, 0.0 );
+      DoubleDouble r = a - q1 * b;
+      double q2 = r.hi / b.hi;
+      r = r - q2 * b;
+      double q3 = r.hi / b.hi;
+      return DoubleDouble( q1, q2 ) + q3;
+   }
+
+   DoubleDouble&
+   operator+=( const DoubleDouble& value )
+   {
+      return *this = *this + value;
+   }
+
+   DoubleDouble&
+   operator-=( const DoubleDouble& value )
+   {
+      return *this = *this - value;
+   }
+
+   DoubleDouble&
+   operator*=( const DoubleDouble& value )
+   {
+      return *this = *this * value;
+   }
+
+   DoubleDouble&
+   operator/=( const DoubleDouble& value )
+   {
+      return *this = *this / value;
+   }
+
+   friend bool
+   operator==( const DoubleDouble& a, const DoubleDouble& b )
+   {
+      return a.hi == b.hi && a.lo == b.lo;
+   }
+
+   friend bool
+   operator!=( const DoubleDouble& a, const DoubleDouble& b )
+   {
+      return !( a == b );
+   }
+
+   friend bool
+   operator<( const DoubleDouble& a, const DoubleDouble& b )
+   {
+      return a.hi < b.hi || ( a.hi == b.hi && a.lo < b.lo );
+   }
+
+   friend bool
+   operator>( const DoubleDouble& a, const DoubleDouble& b )
+   {
+      return b < a;
+   }
+
+   friend bool
+   operator<=( const DoubleDouble& a, const DoubleDouble& b )
+   {
+      return a.hi < b.hi || ( a.hi == b.hi && a.lo <= b.lo );
+   }
+
+   friend bool
+   operator>=( const DoubleDouble& a, const DoubleDouble& b )
+   {
+      return b <= a;
+   }
+
+   friend DoubleDouble
+   floor( const DoubleDouble& a )
+   {
+      double hi = std::floor( a.hi );
+      if( hi != a.hi )
+         return DoubleDouble( hi, 0.0 );
+      return DoubleDouble( hi, std::floor( a.lo ) );
+   }
+
+   friend DoubleDouble
+   ceil( const DoubleDouble& a )
+   {
+      double hi = std::ceil( a.hi );
+      if( hi != a.hi )
+         return DoubleDouble( hi, 0.0 );
+      return DoubleDouble( hi, std::ceil( a.lo ) );
+   }
+
+   /**
+    * parses a decimal number in the format of strtod without hexadecimal digits
+    * @param s
+    * @return whether the whole string is a number
+    */
+   bool
+   parse( const String& s )
+   {
+      size_t i = 0;
+      bool negated = false;
+      if( i < s.size() && ( s[i] == '+' || s[i] == '-' ) )
+         negated = s[i++] == '-';
+      String rest = s.substr( i );
+      for( char& c : rest )
+         c = (char)std::tolower( (unsigned char)c );
+      if( rest == "inf" || rest == "infinity" || rest == "nan" )
+      {
+         *this = rest == "nan" ? std::numeric_limits<double>::quiet_NaN()
+                               : std::numeric_limits<double>::infinity();
+         if( negated )
+            *this = -*this;
+         return true;
+      }
+      // the binary type holds 256 bits far beyond the precision of double-double, rounds to its parts correctly, and
+      // validates the format
+      if( rest.empty() || !( std::isdigit( (unsigned char)rest[0] ) || rest[0] == '.' ) )
+         return false;
+      try
+      {
+         using Binary = boost::multiprecision::number<
+             boost::multiprecision::cpp_bin_float<256, boost::multiprecision::digit_base_2>>;
+         *this = DoubleDouble( Binary( rest ) );
+      }
+      catch( const std::runtime_error& )
+      {
+         return false;
+      }
+      if( negated )
+         *this = -*this;
+      return true;
+   }
+
+   /**
+    * prints the number in the general format of printf
+    * @param precision number of significant digits or 0 for the shortest string reproducing the number
+    */
+   String
+   toString( int precision = 0 ) const
+   {
+      if( lo == 0.0 || !std::isfinite( hi ) )
+         return precision == 0 || precision >= std::numeric_limits<double>::max_digits10
+                    ? fmt::format( "{}", hi )
+                    : fmt::format( "{:.{}g}", hi, precision );
+      boost::multiprecision::cpp_dec_float_50 value { hi };
+      value += lo;
+      if( precision >= 1 )
+         return value.str( precision, std::ios_base::fmtflags( 0 ) );
+      // the lower part may lie far below the upper one so that the digits of
+      // the decimal type are tried until the number is reproduced
+      for( precision = std::numeric_limits<double>::max_digits10 + 1;
+           precision < std::numeric_limits<boost::multiprecision::cpp_dec_float_50>::digits10;
+           ++precision )
+      {
+         String result = value.str( precision, std::ios_base::fmtflags( 0 ) );
+         DoubleDouble parsed;
+         if( parsed.parse( result ) && parsed == *this )
+            return result;
+      }
+      return value.str( precision, std::ios_base::fmtflags( 0 ) );
+   }
+
+   friend std::ostream&
+   operator<<( std::ostream& out, const DoubleDouble& value )
+   {
+      return out << value.toString( std::max( (int)out.precision(), 1 ) );
+   }
+
+   friend std::istream&
+   operator>>( std::istream& in, DoubleDouble& value )
+   {
+      String token;
+      if( in >> token && !value.parse( token ) )
+         in.setstate( std::ios::failbit );
+      return in;
+   }
+};
+
+inline DoubleDouble
+abs( const DoubleDouble& a )
+{
+   return a.getHi() < 0.0 ? -a : a;
+}
+
+inline DoubleDouble
+fabs( const DoubleDouble& a )
+{
+   return abs( a );
+}
+
+inline DoubleDouble
+trunc( const DoubleDouble& a )
+{
+   return a.getHi() < 0.0 ? ceil( a ) : floor( a );
+}
+
+inline DoubleDouble
+round( const DoubleDouble& a )
+{
+   return a.getHi() < 0.0 ? -floor( 0.5 - a ) : floor( a + 0.5 );
+}
+
+inline DoubleDouble
+sqrt( const DoubleDouble& a )
+{
+   if( a.getHi() <= 0.0 || !std::isfinite( a.getHi() ) )
+      return std::sqrt( a.getHi() );
+   double root = std::sqrt( a.getHi() );
+   DoubleDouble residual = a - DoubleDouble( root ) * root;
+   return DoubleDouble( root, residual.getHi() * ( 0.5 / root ) );
+}
+
+inline DoubleDouble
+ldexp( const DoubleDouble& a, int exponent )
+{
+   return DoubleDouble( std::ldexp( a.getHi(), exponent ), std::ldexp( a.getLo(), exponent ) );
+}
+
+inline DoubleDouble
+frexp( const DoubleDouble& a, int* exponent )
+{
+   double hi = std::frexp( a.getHi(), exponent );
+   return DoubleDouble( hi, std::ldexp( a.getLo(), -*exponent ) );
+}
+
+inline DoubleDouble
+copysign( const DoubleDouble& a, const DoubleDouble& b )
+{
+   return std::signbit( a.getHi() ) != std::signbit( b.getHi() ) ? -a : a;
+}
+
+inline bool
+isinf( const DoubleDouble& a )
+{
+   return std::isinf( a.getHi() );
+}
+
+inline bool
+isnan( const DoubleDouble& a )
+{
+   return std::isnan( a.getHi() );
+}
+
+inline bool
+isfinite( const DoubleDouble& a )
+{
+   return std::isfinite( a.getHi() );
+}
+
+} // namespace bugger
+
+namespace std
+{
+
+template <>
+class numeric_limits<bugger::DoubleDouble>
+{
+ public:
+   static constexpr bool is_specialized = true;
+   static constexpr bool is_signed = true;
+   static constexpr bool is_integer = false;
+   static constexpr bool is_exact = false;
+   static constexpr bool has_infinity = true;
+   static constexpr bool has_quiet_NaN = true;
+   static constexpr bool has_signaling_NaN = true;
+   static constexpr float_denorm_style has_denorm = denorm_present;
+   static constexpr bool has_denorm_loss = false;
+   static constexpr float_round_style round_style = round_to_nearest;
+   static constexpr bool is_iec559 = false;
+   static constexpr bool is_bounded = true;
+   static constexpr bool is_modulo = false;
+   static constexpr int digits = 106;
+   static constexpr int digits10 = 31;
+   static constexpr int max_digits10 = 33;
+   static constexpr int radix = 2;
+   static constexpr int min_exponent = numeric_limits<double>::min_exponent + 53;
+   static constexpr int min_exponent10 = numeric_limits<double>::min_exponent10 + 16;
+   static constexpr int max_exponent = numeric_limits<double>::max_exponent;
+   static constexpr int max_exponent10 = numeric_limits<double>::max_exponent10;
+   static constexpr bool traps = false;
+   static constexpr bool tinyness_before = false;
+
+   static bugger::DoubleDouble
+   min()
+   {
+      // smallest number whose lower part is still normalized
+      return std::ldexp( 1.0, min_exponent - 1 );
+   }
+
+   static bugger::DoubleDouble
+   max()
+   {
+      return bugger::DoubleDouble( numeric_limits<double>::max(), std::ldexp( numeric_limits<double>::max(), -54 ) );
+   }
+
+   static bugger::DoubleDouble
+   lowest()
+   {
+      return -max();
+   }
+
+   static bugger::DoubleDouble
+   epsilon()
+   {
+      return std::ldexp( 1.0, 1 - digits );
+   }
+
+   static bugger::DoubleDouble
+   round_error()
+   {
+      return 0.5;
+   }
+
+   static bugger::DoubleDouble
+   infinity()
+   {
+      return numeric_limits<double>::infinity();
+   }
+
+   static bugger::DoubleDouble
+   quiet_NaN()
+   {
+      return numeric_limits<double>::quiet_NaN();
+   }
+
+   static bugger::DoubleDouble
+   signaling_NaN()
+   {
+      return numeric_limits<double>::signaling_NaN();
+   }
+
+   static bugger::DoubleDouble
+   denorm_min()
+   {
+      return numeric_limits<double>::denorm_min();
+   }
+};
+
+} // namespace std
+
+namespace fmt
+{
+
+template <>
+struct formatter<bugger::DoubleDouble> : formatter<string_view>
+{
+   template <typename FormatContext>
+   auto
+   format( const bugger::DoubleDouble& value, FormatContext& ctx ) -> decltype( ctx.out() )
+   {
+      bugger::String string = value.toString();
+      return formatter<string_view>::format( string_view( string.data(), string.size() ), ctx );
+   }
+};
+
+} // namespace fmt
+
+#endif
@@ -73,6 +73,18 @@ class Flags
       return state == joinFlags( flags... );
    }
 
+   bool
+   operator==( const Flags& other ) const
+   {
+      return state == other.state;
+   }
+
+   bool
+   operator!=( const Flags& other ) const
+   {
+      return state != other.state;
+   }
+
    template <typename Archive>
    void
    serialize( Archive& ar, const unsigned int version )
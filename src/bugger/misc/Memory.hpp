@@ -0,0 +1,105 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _BUGGER_MISC_MEMORY_HPP_
+#define _BUGGER_MISC_MEMORY_HPP_
+
+#include "bugger/misc/String.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace bugger
+{
+
+/// peak resident memory of the process in bytes or 0 if unknown
+inline std::size_t
+get_peak_memory()
+{
+#ifndef _WIN32
+   struct rusage usage;
+   if( getrusage( RUSAGE_SELF, &usage ) != 0 )
+      return 0;
+#ifdef __APPLE__
+   return static_cast<std::size_t>( usage.ru_maxrss );
+#else
+   return static_cast<std::size_t>( usage.ru_maxrss ) * 1024;
+#endif
+#else
+   return 0;
+#endif
+}
+
+/// current resident memory of the process in bytes, where the peak serves as
+/// upper bound if the current value is not available
+inline std::size_t
+get_resident_memory()
+{
+#ifdef __linux__
+   std::FILE* file = std::fopen( "/proc/self/statm", "r" );
+   if( file != nullptr )
+   {
+      unsigned long size;
+      unsigned long resident;
+      int count = std::fscanf( file, "%lu %lu", &size, &resident );
+      std::fclose( file );
+      if( count == 2 )
+         return static_cast<std::size_t>( resident ) *
+                static_cast<std::size_t>( sysconf( _SC_PAGESIZE ) );
+   }
+#endif
+   return get_peak_memory();
+}
+
+/// bytes held by the buffer of the vector
+template <typename T, typename A>
+std::size_t
+get_memory_usage( const std::vector<T, A>& vector )
+{
+   return vector.capacity() * sizeof( T );
+}
+
+/// bytes held by the vector of strings including the buffers of long strings
+template <typename A>
+std::size_t
+get_memory_usage( const std::vector<String, A>& vector )
+{
+   std::size_t bytes = vector.capacity() * sizeof( String );
+   for( const auto& string : vector )
+   {
+      const char* data = string.data();
+      const char* object = reinterpret_cast<const char*>( &string );
+      if( data < object || data >= object + sizeof( String ) )
+         bytes += string.capacity() + 1;
+   }
+   return bytes;
+}
+
+} // namespace bugger
+
+#endif
@@ -26,6 +26,7 @@
 #define _BUGGER_MISC_MULTIPRECISION_HPP_
 
 #include "bugger/Config.hpp"
+#include "bugger/misc/DoubleDouble.hpp"
 
 #include <boost/serialization/split_free.hpp>
 
@@ -45,6 +45,9 @@ namespace bugger
       std::string settings_file;
       std::string target_settings_file;
       std::string solution_file;
+      std::string worker_address;
+      std::string manifest_file;
+      std::string output_directory;
       std::vector<std::string> unparsed_options;
       bool is_complete;
 
@@ -84,6 +87,12 @@ namespace bugger
             return false;
          }
 
+         if( fileNotFound(manifest_file) )
+         {
+            fmt::print("file {} is not valid\n", manifest_file);
+            return false;
+         }
+
          return true;
       }
 
@@ -119,6 +128,18 @@ namespace bugger
                              value(&solution_file),
                              "filename for reference solution or unknown/infeasible/unbounded");
 
+         desc.add_options( )("worker,w",
+                             value(&worker_address),
+                             "serve solves as worker on address unix:PATH or HOST:PORT");
+
+         desc.add_options( )("manifest,m",
+                             value(&manifest_file),
+                             "filename for job manifest to bug concurrently in service mode");
+
+         desc.add_options( )("directory,d",
+                             value(&output_directory),
+                             "directory for output files");
+
          if( opts.empty( ))
          {
             fmt::print("\n{}\n", desc);
@@ -265,7 +265,7 @@ class ParameterSet
          set( parsedval );
       }
 
-      std::vector<std::string> split(std::string const &input) {
+      Vec<std::string> split(std::string const &input) {
          std::istringstream buffer(input);
          Vec<std::string> ret((std::istream_iterator<std::string>(buffer)),
                               std::istream_iterator<std::string>());
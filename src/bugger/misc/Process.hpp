@@ -0,0 +1,171 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _BUGGER_MISC_PROCESS_HPP_
+#define _BUGGER_MISC_PROCESS_HPP_
+
+#include "bugger/misc/String.hpp"
+#include "bugger/misc/Vec.hpp"
+#include <boost/filesystem.hpp>
+#include <cassert>
+#include <cerrno>
+#include <cstdlib>
+#include <stdexcept>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+#endif
+
+namespace bugger
+{
+
+/// directory with a unique name for the files of a single solve, which is
+/// placed in memory if possible and removed with its content on destruction
+class ScratchDirectory
+{
+ public:
+   explicit ScratchDirectory( const String& prefix )
+   {
+      boost::filesystem::path parent = "/dev/shm";
+      boost::system::error_code error;
+      if( !boost::filesystem::is_directory( parent, error ) )
+         parent = boost::filesystem::temp_directory_path( error );
+      path = parent / boost::filesystem::unique_path(
+                          ( prefix + "-%%%%-%%%%-%%%%-%%%%" ).c_str() );
+      if( !boost::filesystem::create_directory( path, error ) )
+         throw std::runtime_error( "could not create scratch directory " +
+                                   path.string() );
+   }
+
+   ScratchDirectory( const ScratchDirectory& ) = delete;
+
+   ScratchDirectory&
+   operator=( const ScratchDirectory& ) = delete;
+
+   ~ScratchDirectory()
+   {
+      boost::system::error_code error;
+      boost::filesystem::remove_all( path, error );
+   }
+
+   /// path of the given file inside the directory
+   String
+   getFile( const String& name ) const
+   {
+      return ( path / name.c_str() ).string();
+   }
+
+ private:
+   boost::filesystem::path path;
+};
+
+#ifndef _WIN32
+/// starts the executable found in the search path with the given arguments
+/// directly without a shell and redirects its standard and error output to the
+/// given file, returns the process identifier or -1 if the executable could not
+/// be started
+inline pid_t
+spawn_process( const Vec<String>& arguments, const String& output )
+{
+   assert( !arguments.empty() );
+   Vec<char*> argv;
+   for( const auto& argument : arguments )
+      argv.push_back( const_cast<char*>( argument.c_str() ) );
+   argv.push_back( nullptr );
+
+   posix_spawn_file_actions_t actions;
+   if( posix_spawn_file_actions_init( &actions ) != 0 )
+      return -1;
+   posix_spawn_file_actions_addopen( &actions, STDOUT_FILENO, output.c_str(),
+                                     O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+   posix_spawn_file_actions_adddup2( &actions, STDOUT_FILENO, STDERR_FILENO );
+
+   pid_t pid;
+   int error =
+       posix_spawnp( &pid, argv[0], &actions, nullptr, argv.data(), environ );
+   posix_spawn_file_actions_destroy( &actions );
+   if( error != 0 )
+      return -1;
+   return pid;
+}
+
+/// waits for the given process, returns its exit code, 128 plus the number of
+/// the terminating signal, or -1 if the process could not be waited for
+inline int
+wait_process( pid_t pid )
+{
+   int status;
+   while( waitpid( pid, &status, 0 ) < 0 )
+   {
+      if( errno != EINTR )
+         return -1;
+   }
+   if( WIFEXITED( status ) )
+      return WEXITSTATUS( status );
+   if( WIFSIGNALED( status ) )
+      return 128 + WTERMSIG( status );
+   return -1;
+}
+
+/// checks without blocking and without reaping whether the given process has
+/// terminated
+inline bool
+is_process_terminated( pid_t pid )
+{
+   siginfo_t info;
+   info.si_pid = 0;
+   if( waitid( P_PID, pid, &info, WEXITED | WNOHANG | WNOWAIT ) < 0 )
+      return errno != EINTR;
+   return info.si_pid != 0;
+}
+#endif
+
+/// runs the executable found in the search path with the given arguments
+/// directly without a shell and discards its output, returns the exit code or
+/// -1 if the executable could not be run
+inline int
+run_process( const Vec<String>& arguments )
+{
+   assert( !arguments.empty() );
+#ifndef _WIN32
+   pid_t pid = spawn_process( arguments, "/dev/null" );
+   if( pid < 0 )
+      return -1;
+   int code = wait_process( pid );
+   return code < 128 ? code : -1;
+#else
+   String command;
+   for( const auto& argument : arguments )
+      command += "\"" + argument + "\" ";
+   command += ">NUL";
+   return std::system( command.c_str() );
+#endif
+}
+
+} // namespace bugger
+
+#endif
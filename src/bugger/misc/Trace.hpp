@@ -0,0 +1,335 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef _BUGGER_MISC_TRACE_HPP_
+#define _BUGGER_MISC_TRACE_HPP_
+
+#include "bugger/Config.hpp"
+
+/// scoped trace events in the Chrome trace-event format, viewable in Perfetto
+/// or chrome://tracing, which are only compiled in if BUGGER_USE_TRACE is set
+///
+///    BUGGER_TRACE_SCOPE( category, name[, value] );
+///       records a complete event from here until the end of the scope
+///    BUGGER_TRACE_INSTANT( category, name[, value] );
+///       records an instant event at this point
+///    BUGGER_TRACE_SESSION();
+///       records the events of this thread in a new session until the end of
+///       the scope
+///    BUGGER_TRACE_JOIN( session );
+///       records the events of this thread in the given session, obtained by
+///       BUGGER_TRACE_CURRENT() on another thread, until the end of the scope
+///
+/// where a nonnegative value is added to the arguments of the event, and
+/// none expands to any code or evaluates its arguments otherwise, except that
+/// BUGGER_TRACE_CURRENT() is 0 and the session of BUGGER_TRACE_JOIN is unused
+
+#ifdef BUGGER_USE_TRACE
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace bugger
+{
+
+/// process-wide collection of trace events, where every thread appends to a
+/// buffer of its own so that recording from parallel threads does not contend,
+/// and every event belongs to the session of its thread so that concurrent
+/// runs only write their own events, while the buffers of exited threads keep
+/// their events and are handed to new threads so that their number is bounded
+/// by the number of simultaneous threads
+class Tracer
+{
+ public:
+   struct Event
+   {
+      std::string name;
+      const char* category;
+      char phase;
+      long long start;
+      long long duration;
+      long long value;
+      int session;
+   };
+
+   static Tracer&
+   get()
+   {
+      static Tracer tracer;
+      return tracer;
+   }
+
+   /// microseconds since the start of the tracer
+   long long
+   now() const
+   {
+      return std::chrono::duration_cast<std::chrono::microseconds>(
+                 std::chrono::steady_clock::now() - epoch )
+          .count();
+   }
+
+   /// session of the calling thread, which is 0 unless set by a TraceSession
+   static int&
+   session()
+   {
+      thread_local int current = 0;
+      return current;
+   }
+
+   /// @return identifier of a new session
+   int
+   open()
+   {
+      return ++nsessions;
+   }
+
+   void
+   record( Event&& event )
+   {
+      event.session = session();
+      Buffer& buffer = local();
+      std::lock_guard<std::mutex> lock( buffer.mutex );
+      buffer.events.push_back( std::move( event ) );
+   }
+
+   /// writes all events of the given session recorded so far as JSON object to
+   /// the given file
+   bool
+   write( const std::string& filename, int session )
+   {
+      std::ofstream file( filename );
+      if( !file )
+         return false;
+#ifndef _WIN32
+      long long pid = getpid();
+#else
+      long long pid = 0;
+#endif
+      file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+      file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+           << ",\"tid\":0,\"args\":{\"name\":\"bugger\"}}";
+      std::lock_guard<std::mutex> lock( mutex );
+      for( const auto& buffer : buffers )
+      {
+         std::lock_guard<std::mutex> events_lock( buffer->mutex );
+         bool named = false;
+         for( const auto& event : buffer->events )
+         {
+            if( event.session != session )
+               continue;
+            if( !named )
+            {
+               file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":"
+                    << pid << ",\"tid\":" << buffer->tid
+                    << ",\"args\":{\"name\":\""
+                    << ( buffer->tid == 1 ? "main" : "thread" ) << " "
+                    << buffer->tid << "\"}}";
+               named = true;
+            }
+            file << ",\n{\"name\":\"";
+            escape( file, event.name );
+            file << "\",\"cat\":\"" << event.category << "\",\"ph\":\""
+                 << event.phase << "\",\"ts\":" << event.start;
+            if( event.phase == 'X' )
+               file << ",\"dur\":" << event.duration;
+            else
+               file << ",\"s\":\"t\"";
+            file << ",\"pid\":" << pid << ",\"tid\":" << buffer->tid;
+            if( event.value >= 0 )
+               file << ",\"args\":{\"value\":" << event.value << "}";
+            file << "}";
+         }
+      }
+      file << "\n]}\n";
+      return static_cast<bool>( file );
+   }
+
+ private:
+   struct Buffer
+   {
+      std::mutex mutex;
+      int tid;
+      bool active;
+      std::vector<Event> events;
+   };
+
+   /// releases the buffer of its thread on exit
+   struct Owner
+   {
+      Buffer* buffer = nullptr;
+
+      ~Owner()
+      {
+         if( buffer != nullptr )
+            Tracer::get().release( *buffer );
+      }
+   };
+
+   std::chrono::steady_clock::time_point epoch;
+   std::atomic<int> nsessions{ 0 };
+   std::mutex mutex;
+   std::vector<std::unique_ptr<Buffer>> buffers;
+
+   Tracer() : epoch( std::chrono::steady_clock::now() ) {}
+
+   Buffer&
+   local()
+   {
+      thread_local Owner owner;
+      if( owner.buffer == nullptr )
+      {
+         std::lock_guard<std::mutex> lock( mutex );
+         for( const auto& buffer : buffers )
+         {
+            if( !buffer->active )
+            {
+               owner.buffer = buffer.get();
+               break;
+            }
+         }
+         if( owner.buffer == nullptr )
+         {
+            buffers.emplace_back( new Buffer() );
+            owner.buffer = buffers.back().get();
+            owner.buffer->tid = static_cast<int>( buffers.size() );
+         }
+         owner.buffer->active = true;
+      }
+      return *owner.buffer;
+   }
+
+   void
+   release( Buffer& buffer )
+   {
+      std::lock_guard<std::mutex> lock( mutex );
+      buffer.active = false;
+   }
+
+   static void
+   escape( std::ofstream& file, const std::string& string )
+   {
+      for( char c : string )
+      {
+         if( c == '"' || c == '\\' )
+            file << '\\' << c;
+         else if( static_cast<unsigned char>( c ) >= 0x20 )
+            file << c;
+      }
+   }
+};
+
+/// records a complete event covering its lifetime
+class TraceScope
+{
+ public:
+   template <typename NAME>
+   TraceScope( const char* category, const NAME& name, long long value = -1 )
+       : event{ std::string( name.data(), name.size() ), category, 'X',
+                Tracer::get().now(), 0, value, 0 }
+   {
+   }
+
+   TraceScope( const char* category, const char* name, long long value = -1 )
+       : event{ name, category, 'X', Tracer::get().now(), 0, value, 0 }
+   {
+   }
+
+   TraceScope( const TraceScope& ) = delete;
+
+   TraceScope&
+   operator=( const TraceScope& ) = delete;
+
+   ~TraceScope()
+   {
+      event.duration = Tracer::get().now() - event.start;
+      Tracer::get().record( std::move( event ) );
+   }
+
+ private:
+   Tracer::Event event;
+};
+
+inline void
+trace_instant( const char* category, const char* name, long long value = -1 )
+{
+   Tracer::get().record(
+       Tracer::Event{ name, category, 'i', Tracer::get().now(), 0, value, 0 } );
+}
+
+/// assigns the calling thread to a session for its lifetime
+class TraceSession
+{
+ public:
+   explicit TraceSession( int session ) : previous( Tracer::session() )
+   {
+      Tracer::session() = session;
+   }
+
+   TraceSession( const TraceSession& ) = delete;
+
+   TraceSession&
+   operator=( const TraceSession& ) = delete;
+
+   ~TraceSession() { Tracer::session() = previous; }
+
+ private:
+   int previous;
+};
+
+} // namespace bugger
+
+#define BUGGER_TRACE_CONCAT_( a, b ) a##b
+#define BUGGER_TRACE_CONCAT( a, b ) BUGGER_TRACE_CONCAT_( a, b )
+#define BUGGER_TRACE_SCOPE( ... )                                             \
+   ::bugger::TraceScope BUGGER_TRACE_CONCAT( bugger_trace_scope_,             \
+                                             __LINE__ )( __VA_ARGS__ )
+#define BUGGER_TRACE_INSTANT( ... ) ::bugger::trace_instant( __VA_ARGS__ )
+#define BUGGER_TRACE_SESSION()                                                \
+   ::bugger::TraceSession BUGGER_TRACE_CONCAT( bugger_trace_session_,         \
+                                               __LINE__ )(                    \
+       ::bugger::Tracer::get().open() )
+#define BUGGER_TRACE_JOIN( session )                                          \
+   ::bugger::TraceSession BUGGER_TRACE_CONCAT( bugger_trace_session_,         \
+                                               __LINE__ )( session )
+#define BUGGER_TRACE_CURRENT() ::bugger::Tracer::session()
+
+#else
+
+#define BUGGER_TRACE_SCOPE( ... ) static_cast<void>( 0 )
+#define BUGGER_TRACE_INSTANT( ... ) static_cast<void>( 0 )
+#define BUGGER_TRACE_SESSION() static_cast<void>( 0 )
+#define BUGGER_TRACE_JOIN( session ) static_cast<void>( session )
+#define BUGGER_TRACE_CURRENT() 0
+
+#endif
+
+#endif
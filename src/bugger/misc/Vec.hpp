@@ -36,6 +36,12 @@ using Vec = std::vector<T, Allocator<T>>;
 template <typename T, int N>
 using SmallVec = boost::container::small_vector<T, N, Allocator<T>>;
 
+template <typename T>
+using ScratchVec = std::vector<T, ScratchAllocator<T>>;
+
+template <typename T, int N>
+using ScratchSmallVec = boost::container::small_vector<T, N, ScratchAllocator<T>>;
+
 } // namespace bugger
 
 #endif
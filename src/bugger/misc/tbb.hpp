@@ -59,6 +59,8 @@
 #include "tbb/concurrent_vector.h"
 #include "tbb/parallel_for.h"
 #include "tbb/parallel_invoke.h"
+#include "tbb/parallel_scan.h"
+#include "tbb/parallel_sort.h"
 #include "tbb/partitioner.h"
 #include "tbb/task_arena.h"
 #include "tbb/tick_count.h"
@@ -25,15 +25,23 @@
 #ifndef __BUGGER_MODIFIERS_BUGGERMODIFIER_HPP__
 #define __BUGGER_MODIFIERS_BUGGERMODIFIER_HPP__
 
+#include "bugger/data/BugSignature.hpp"
 #include "bugger/data/BuggerParameters.hpp"
+#include "bugger/data/CostModel.hpp"
+#include "bugger/data/FailureHistory.hpp"
+#include "bugger/data/ReductionLog.hpp"
+#include "bugger/data/SolveScheduler.hpp"
+#include "bugger/data/WorkerPool.hpp"
 #include "bugger/interfaces/BuggerStatus.hpp"
 #include "bugger/interfaces/SolverInterface.hpp"
+#include "bugger/misc/Trace.hpp"
 
 #ifdef BUGGER_TBB
 #include "bugger/misc/tbb.hpp"
 #else
 #include <chrono>
 #endif
+#include <functional>
 
 
 namespace bugger
@@ -68,6 +76,13 @@ namespace bugger
       const Num<REAL>& num;
       const BuggerParameters& parameters;
       std::shared_ptr<SolverFactory<REAL>> factory;
+      std::shared_ptr<WorkerPool<REAL>> pool { };
+      std::shared_ptr<SolveScheduler::Client> client { };
+      std::shared_ptr<CostModel<REAL>> model { };
+      std::shared_ptr<BugSignature> signature { };
+      std::shared_ptr<ReductionLog<REAL>> reductionlog { };
+      std::function<void(const Problem<REAL>&)> progress { };
+      const Timer* timer = nullptr;
       int nchgcoefs = 0;
       int nfixedvars = 0;
       int nchgsides = 0;
@@ -75,8 +90,24 @@ namespace bugger
       int nchgsettings = 0;
       int ndeletedrows = 0;
       int nsolves = 0;
+      int nproxysolves = 0;
+      int nproxybugs = 0;
+      int nproxyokays = 0;
+      int nproxylimits = 0;
+      int nproxyerrors = 0;
+      long long nevaluatedbatches = 0;
+      long long nacceptedbatches = 0;
+      long long nevaluatedelements = 0;
+      double solve_time = -1.0;
+      long long solve_effort = -1;
+      long long fallback_batchsize = 0;
       std::pair<char, SolverStatus> last_result { SolverRetcode::OKAY, SolverStatus::kUnknown };
       long long last_effort = -1;
+      long long effort_bound = -1;
+      long long proxy_budget = -1;
+      FailureHistory history { };
+      Vec<int> history_keys { };
+      long long ntraversals = 0;
 
    public:
 
@@ -121,12 +152,16 @@ namespace bugger
             return ModifierStatus::kDidNotRun;
 
          msg.info("modifier {} running\n", name);
+         BUGGER_TRACE_SCOPE("modifier", name);
 #ifdef BUGGER_TBB
          auto start = tbb::tick_count::now( );
 #else
          auto start = std::chrono::steady_clock::now();
 #endif
+         this->timer = &timer;
+         history_keys.clear( );
          ModifierStatus result = execute(settings, problem, solution);
+         this->timer = nullptr;
          if( result == ModifierStatus::kSuccessful )
             nsuccessCall++;
          if ( result != ModifierStatus::kDidNotRun && result != ModifierStatus::kNotAdmissible )
@@ -151,6 +186,81 @@ namespace bugger
          message.info(" {:>18} {:>12} {:>12} {:>18.1f} {:>12} {:>18.3f}\n", name, ncalls, changes, success, nsolves, execTime);
       }
 
+      void
+      printProxyStats(const Message& message)
+      {
+         message.info(" {:>18} {:>12} {:>12} {:>12} {:>12} {:>12} {:>12}\n", name, nproxysolves, nproxybugs, nproxyokays,
+                      nproxylimits, nproxyerrors, nsolves - nproxysolves);
+      }
+
+      void
+      setWorkerPool(const std::shared_ptr<WorkerPool<REAL>>& value)
+      {
+         this->pool = value;
+      }
+
+      void
+      setCostModel(const std::shared_ptr<CostModel<REAL>>& value)
+      {
+         this->model = value;
+      }
+
+      void
+      setSchedulerClient(const std::shared_ptr<SolveScheduler::Client>& value)
+      {
+         this->client = value;
+      }
+
+      /**
+       * sets the signature which failures have to reproduce to be considered as bug
+       * @param value
+       */
+      void
+      setBugSignature(const std::shared_ptr<BugSignature>& value)
+      {
+         this->signature = value;
+      }
+
+      /**
+       * sets the log to which every accepted batch is appended
+       * @param value
+       */
+      void
+      setReductionLog(const std::shared_ptr<ReductionLog<REAL>>& value)
+      {
+         this->reductionlog = value;
+      }
+
+      /**
+       * sets the solving effort which reproductions have to undercut if effort is minimized or -1 if unknown
+       * @param value
+       */
+      void
+      setEffortBound(long long value)
+      {
+         this->effort_bound = value;
+      }
+
+      /**
+       * sets the solving effort to which proxy solves are restricted before solving completely or -1 to disable them
+       * @param value
+       */
+      void
+      setProxyBudget(long long value)
+      {
+         this->proxy_budget = value;
+      }
+
+      /**
+       * sets the function that is informed about the current problem after every evaluated batch
+       * @param value
+       */
+      void
+      setProgressCallback(const std::function<void(const Problem<REAL>&)>& value)
+      {
+         this->progress = value;
+      }
+
       void
       setName(const String& value)
       {
@@ -187,6 +297,18 @@ namespace bugger
          return last_effort;
       }
 
+      long long
+      getNEvaluatedBatches( ) const
+      {
+         return nevaluatedbatches;
+      }
+
+      long long
+      getNAcceptedBatches( ) const
+      {
+         return nacceptedbatches;
+      }
+
    protected:
 
       virtual ModifierStatus
@@ -198,22 +320,443 @@ namespace bugger
          return timer.getTime( ) >= tlim;
       }
 
+      static bool
+      is_memory_exceeded(double memlimit)
+      {
+         return memlimit < std::numeric_limits<double>::max( ) && get_resident_memory( ) > memlimit * 1048576.0;
+      }
+
       BuggerStatus
       call_solver(SolverSettings& settings, const Problem<REAL>& problem, const Solution<REAL>& solution)
+      {
+         if( pool )
+         {
+            auto task = submit(settings, problem, solution);
+            if( task )
+               return collect(settings, problem, solution, task);
+         }
+         return call_local_solver(settings, problem, solution);
+      }
+
+      BuggerStatus
+      call_local_solver(SolverSettings& settings, const Problem<REAL>& problem, const Solution<REAL>& solution)
+      {
+         if( proxy_budget >= 0 )
+         {
+            boost::optional<BuggerStatus> status = call_proxy_solver(settings, problem, solution);
+            if( status )
+               return *status;
+         }
+         ++nsolves;
+         std::pair<char, SolverStatus> result { };
+         String fingerprint { };
+         auto solver = factory->create_solver(msg);
+         {
+            SolveScheduler::Slot slot { client };
+            auto start = std::chrono::steady_clock::now( );
+            {
+               BUGGER_TRACE_SCOPE("solver", "doSetUp");
+               solver->doSetUp(settings, problem, solution);
+            }
+            if( !parameters.debug_filename.empty( ) )
+            {
+               BUGGER_TRACE_SCOPE("io", "debug");
+               solver->writeInstance(parameters.debug_filename, true, true);
+            }
+            {
+               BUGGER_TRACE_SCOPE("solver", "solve");
+               result = solver->solve(parameters.passcodes);
+            }
+            solve_effort = solver->getSolvingEffort( );
+            if( signature )
+               fingerprint = solver->getFingerprint( );
+            solve_time = std::chrono::duration<double>(std::chrono::steady_clock::now( ) - start).count( );
+         }
+         BuggerStatus status = check_result(result, solve_effort, fingerprint);
+         if( status != BuggerStatus::kOkay )
+            solver->acceptSolve( );
+         return status;
+      }
+
+      /**
+       * solves the instance restricted to the proxy budget as first tier of the evaluation
+       * a batch exhausting the budget is rejected because the issue has to surface within it
+       * @param settings
+       * @param problem
+       * @param solution
+       * @return status if decided by the proxy solve or boost::none if the instance has to be solved completely
+       */
+      boost::optional<BuggerStatus>
+      call_proxy_solver(SolverSettings& settings, const Problem<REAL>& problem, const Solution<REAL>& solution)
       {
          ++nsolves;
+         ++nproxysolves;
+         SolverSettings copy { settings };
+         boost::optional<std::pair<char, SolverStatus>> result { };
+         String fingerprint { };
          auto solver = factory->create_solver(msg);
-         solver->doSetUp(settings, problem, solution);
+         {
+            SolveScheduler::Slot slot { client };
+            auto start = std::chrono::steady_clock::now( );
+            {
+               BUGGER_TRACE_SCOPE("solver", "doSetUp");
+               solver->doSetUp(copy, problem, solution);
+            }
+            if( !parameters.debug_filename.empty( ) )
+            {
+               BUGGER_TRACE_SCOPE("io", "debug");
+               solver->writeInstance(parameters.debug_filename, true, true);
+            }
+            {
+               BUGGER_TRACE_SCOPE("solver", "proxy");
+               result = solver->solveLimited(parameters.passcodes, proxy_budget);
+            }
+            solve_effort = solver->getSolvingEffort( );
+            if( signature )
+               fingerprint = solver->getFingerprint( );
+            solve_time = std::chrono::duration<double>(std::chrono::steady_clock::now( ) - start).count( );
+         }
+         if( !result )
+         {
+            ++nproxylimits;
+            msg.info("\tLimit   - Status {:<23} - Effort{:>20}\n", SolverStatus::kLimit, solve_effort);
+            return BuggerStatus::kOkay;
+         }
+         // errors of a restricted solve might be caused by the restriction
+         if( result->first < SolverRetcode::OKAY )
+         {
+            ++nproxyerrors;
+            return boost::none;
+         }
+         if( result->first == SolverRetcode::OKAY )
+            ++nproxyokays;
+         else
+            ++nproxybugs;
+         settings = std::move(copy);
+         BuggerStatus status = check_result(*result, solve_effort, fingerprint);
+         if( status != BuggerStatus::kOkay )
+            solver->acceptSolve( );
+         return status;
+      }
+
+      /**
+       * checks whether the next traversal of the elements follows the failure history or retests the original order
+       * @return whether the history is enabled and no retest is due
+       */
+      bool
+      follow_history( )
+      {
+         return parameters.history && ( parameters.history_retest <= 0 || ++ntraversals % parameters.history_retest != 0 );
+      }
+
+      /**
+       * identifies the elements traversed by the next apply_batches() in the failure history
+       * @param keys persistent key of every element, for example the row or column it refers to
+       */
+      void
+      set_history_keys(Vec<int> keys)
+      {
+         history_keys = std::move(keys);
+      }
+
+      /**
+       * provides the value a column is fixed to, which is the rounded reference value if available and otherwise the
+       * value closest to zero in the domain
+       * @param problem
+       * @param solution
+       * @param col
+       */
+      REAL
+      get_fixed_value(const Problem<REAL>& problem, const Solution<REAL>& solution, int col) const
+      {
+         REAL fixedval { };
+         if( solution.status == SolutionStatus::kFeasible )
+         {
+            fixedval = solution.primal[ col ];
+            if( problem.getColFlags( )[ col ].test(ColFlag::kIntegral) )
+               fixedval = round(fixedval);
+         }
+         else
+         {
+            if( problem.getColFlags( )[ col ].test(ColFlag::kIntegral) )
+            {
+               if( !problem.getColFlags( )[ col ].test(ColFlag::kUbInf) )
+                  fixedval = min(fixedval, num.epsFloor(problem.getUpperBounds( )[ col ]));
+               if( !problem.getColFlags( )[ col ].test(ColFlag::kLbInf) )
+                  fixedval = max(fixedval, num.epsCeil(problem.getLowerBounds( )[ col ]));
+            }
+            else
+            {
+               if( !problem.getColFlags( )[ col ].test(ColFlag::kUbInf) )
+                  fixedval = min(fixedval, problem.getUpperBounds( )[ col ]);
+               if( !problem.getColFlags( )[ col ].test(ColFlag::kLbInf) )
+                  fixedval = max(fixedval, problem.getLowerBounds( )[ col ]);
+            }
+         }
+         return fixedval;
+      }
+
+      /**
+       * predicts the batch size maximizing the expected reductions per cost if a cost model is available
+       * if the prediction exceeds the regular batch size, the next batches fall back to it when no batch is accepted
+       * @param problem
+       * @param nadmissible number of admissible elements
+       * @param batchsize batch size derived from the number of batches
+       * @param shrink dimension reduced by the elements
+       * @return batch size to be applied
+       */
+      long long
+      predict_batchsize(const Problem<REAL>& problem, long long nadmissible, long long batchsize,
+                        typename CostModel<REAL>::Shrink shrink)
+      {
+         fallback_batchsize = 0;
+         if( !model )
+            return batchsize;
+         long long prediction;
+         if( nevaluatedbatches >= 2 )
+            prediction = model->getBatchSize(problem, nadmissible, nevaluatedbatches - nacceptedbatches,
+                                             nevaluatedelements, shrink);
+         else if( model->getNElements( ) >= 1 )
+            prediction = model->getBatchSize(problem, nadmissible, model->getNRejected( ), model->getNElements( ),
+                                             shrink);
+         else
+            return batchsize;
+         msg.detailed("\tBatch size {} predicted instead of {}\n", prediction, batchsize);
+         if( prediction > batchsize )
+            fallback_batchsize = batchsize;
+         return prediction;
+      }
+
+      /**
+       * forms batches of modifications and keeps the ones which preserve the issue
+       * every batch is built from the subsequent elements until the batch size is reached, if workers are available,
+       * further batches are evaluated speculatively in parallel and committed in order, where they assume either the
+       * acceptance or the rejection of their predecessors depending on the observed acceptance ratio, so that the
+       * outcome equals the sequential evaluation up to automatically restricted limits, and no further batches are
+       * formed once the time limit is reached, elements of many rejected batches are traversed last if the failure
+       * history is enabled except in every periodic retest
+       * @tparam BATCH record of the modifications of a batch
+       * @param settings
+       * @param problem problem to be reduced
+       * @param solution
+       * @param nelements number of elements to be traversed
+       * @param batchsize number of admissible elements in a batch
+       * @param modify modifies element in copy and records it in batch, returns whether element is admissible
+       * @param accept is called for every accepted batch
+       * @param complete finalizes batch in copy before it is evaluated
+       * @return status whether any element was admissible and any batch was accepted
+       */
+      template <typename BATCH, typename MODIFY, typename ACCEPT, typename COMPLETE>
+      ModifierStatus
+      apply_batches(SolverSettings& settings, Problem<REAL>& problem, const Solution<REAL>& solution, int nelements,
+                    long long batchsize, MODIFY&& modify, ACCEPT&& accept, COMPLETE&& complete)
+      {
+         struct Candidate
+         {
+            Problem<REAL> problem;
+            BATCH batch;
+            Vec<int> elements;
+            int end;
+            long long size;
+            std::shared_ptr<typename WorkerPool<REAL>::Task> task;
+         };
+
+         std::deque<Candidate> candidates { };
+         long long fallback_batchsize = this->fallback_batchsize;
+         this->fallback_batchsize = 0;
+         bool admissible = false;
+         bool accepted = false;
+         bool optimistic = false;
+         int element = 0;
+         Vec<int> sequence { };
+         // elements are blamed once per call even if the fallback granularity rejects them again
+         Vec<bool> blamed { };
+         if( follow_history( ) )
+            sequence = history.getSequence(nelements, history_keys);
+
+         while( true )
+         {
+            if( timer != nullptr && is_time_exceeded(*timer, parameters.tlim) )
+            {
+               for( const auto& speculation: candidates )
+                  if( speculation.task )
+                     pool->cancel(speculation.task);
+               break;
+            }
+            // speculative copies of the problem are avoided beyond the memory limit
+            bool exceeded = is_memory_exceeded(parameters.memlimit);
+            int nslots = pool && !exceeded ? max(pool->getNWorkers( ), 1) : 1;
+            if( candidates.empty( ) )
+            {
+               // no batch is pending anymore so that all scratch data can be discarded
+               if( exceeded )
+               {
+                  Arena::local( ).reset( );
+                  Arena::local( ).trim( );
+                  PoolResource::trim( );
+               }
+               else
+                  Arena::local( ).reset( );
+               optimistic = 2 * ( nacceptedbatches + 1 ) > nevaluatedbatches + 2;
+            }
+            while( element < nelements && (int)candidates.size( ) < nslots )
+            {
+               BUGGER_TRACE_SCOPE("batch", "construct");
+               Candidate candidate { Problem<REAL>(optimistic && !candidates.empty( ) ? candidates.back( ).problem : problem),
+                                     BATCH { }, Vec<int> { }, element, 0, nullptr };
+               long long batch = 0;
+               for( ; element < nelements && batch < batchsize; ++element )
+               {
+                  int index = sequence.empty( ) ? element : sequence[ element ];
+                  if( modify(candidate.problem, index, candidate.batch) )
+                  {
+                     ++batch;
+                     if( parameters.history )
+                        candidate.elements.push_back(index);
+                  }
+               }
+               if( batch == 0 )
+                  break;
+               admissible = true;
+               complete(candidate.problem, candidate.batch);
+               candidate.end = element;
+               candidate.size = batch;
+               if( nslots >= 2 )
+                  candidate.task = submit(settings, candidate.problem, solution);
+               candidates.push_back(std::move(candidate));
+            }
+
+            if( candidates.empty( ) )
+            {
+               // check the admissible elements at the regular granularity before giving up on a predicted batch size
+               if( admissible && !accepted && fallback_batchsize >= 1 && fallback_batchsize < batchsize )
+               {
+                  batchsize = fallback_batchsize;
+                  fallback_batchsize = 0;
+                  element = 0;
+                  continue;
+               }
+               break;
+            }
+
+            Candidate candidate { std::move(candidates.front( )) };
+            candidates.pop_front( );
+            bool reproduced;
+            {
+               BUGGER_TRACE_SCOPE("batch", "evaluate", candidate.size);
+               reproduced = ( candidate.task
+                              ? collect(settings, candidate.problem, solution, candidate.task)
+                              : call_solver(settings, candidate.problem, solution) ) != BuggerStatus::kOkay;
+            }
+            ++nevaluatedbatches;
+            nevaluatedelements += candidate.size;
+            if( model )
+            {
+               model->observe(CostModel<REAL>::getFeatures(candidate.problem), solve_time, solve_effort);
+               model->record(candidate.size, reproduced);
+            }
+            if( reproduced )
+            {
+               ++nacceptedbatches;
+               accept(candidate.batch);
+               accepted = true;
+               if( reductionlog )
+                  reductionlog->append(name, problem, candidate.problem, settings);
+               problem = std::move(candidate.problem);
+               BUGGER_TRACE_INSTANT("batch", "accept", candidate.size);
+            }
+            else
+            {
+               if( parameters.history )
+               {
+                  blamed.resize(nelements, false);
+                  for( int index: candidate.elements )
+                  {
+                     if( blamed[ index ] )
+                        continue;
+                     blamed[ index ] = true;
+                     history.reject(history_keys.empty( ) ? index : history_keys[ index ]);
+                  }
+               }
+               BUGGER_TRACE_INSTANT("batch", "rollback", candidate.size);
+            }
+            if( progress )
+               progress(problem);
+            if( reproduced != optimistic && !candidates.empty( ) )
+            {
+               BUGGER_TRACE_INSTANT("batch", "discard", (long long)candidates.size( ));
+               for( const auto& speculation: candidates )
+                  if( speculation.task )
+                     pool->cancel(speculation.task);
+               candidates.clear( );
+               element = candidate.end;
+            }
+         }
+
+         if( !admissible )
+            return ModifierStatus::kNotAdmissible;
+         if( !accepted )
+            return ModifierStatus::kUnsuccesful;
+         return ModifierStatus::kSuccessful;
+      }
+
+      template <typename BATCH, typename MODIFY, typename ACCEPT>
+      ModifierStatus
+      apply_batches(SolverSettings& settings, Problem<REAL>& problem, const Solution<REAL>& solution, int nelements,
+                    long long batchsize, MODIFY&& modify, ACCEPT&& accept)
+      {
+         return apply_batches<BATCH>(settings, problem, solution, nelements, batchsize, std::forward<MODIFY>(modify),
+                                     std::forward<ACCEPT>(accept), [](Problem<REAL>&, BATCH&) { });
+      }
+
+   private:
+
+      std::shared_ptr<typename WorkerPool<REAL>::Task>
+      submit(const SolverSettings& settings, const Problem<REAL>& problem, const Solution<REAL>& solution)
+      {
+         BUGGER_TRACE_SCOPE("worker", "submit");
          if( !parameters.debug_filename.empty( ) )
+         {
+            SolverSettings copy { settings };
+            auto solver = factory->create_solver(msg);
+            solver->doSetUp(copy, problem, solution);
             solver->writeInstance(parameters.debug_filename, true, true);
-         std::pair<char, SolverStatus> result = solver->solve(parameters.passcodes);
+         }
+         auto task = pool->submit(settings, problem);
+         if( task )
+            ++nsolves;
+         return task;
+      }
+
+      BuggerStatus
+      collect(SolverSettings& settings, const Problem<REAL>& problem, const Solution<REAL>& solution,
+              const std::shared_ptr<typename WorkerPool<REAL>::Task>& task)
+      {
+         WorkerResult result;
+         {
+            BUGGER_TRACE_SCOPE("worker", "wait");
+            result = pool->wait(task);
+         }
+         if( !result.valid )
+         {
+            msg.warn("Workers failed, solving locally.\n");
+            return call_local_solver(settings, problem, solution);
+         }
+         settings = std::move(result.settings);
+         solve_time = result.time;
+         solve_effort = result.effort;
+         return check_result({ result.retcode, result.status }, result.effort, result.fingerprint);
+      }
+
+      BuggerStatus
+      check_result(std::pair<char, SolverStatus> result, long long effort, const String& fingerprint)
+      {
          if( !SolverStatusCheck::is_value(result.second) )
          {
             msg.error("Error: Solver returned unknown status {}\n", (int)result.second);
             result.second = SolverStatus::kUndefinedError;
             return BuggerStatus::kError;
          }
-         long long effort = solver->getSolvingEffort( );
          if( result.first == SolverRetcode::OKAY )
          {
             msg.info("\tOkay    - Status {:<23} - Effort{:>20}\n", result.second, effort);
@@ -221,6 +764,31 @@ namespace bugger
          }
          else
          {
+            if( signature )
+            {
+               // the first failure defines the signature if the original solve was skipped
+               if( !signature->isPinned( ) )
+                  signature->pin(result, effort, fingerprint);
+               bool matched = signature->matches(result, effort, fingerprint);
+               signature->record(result, effort, fingerprint, matched);
+               if( !matched )
+               {
+                  msg.info("\tDrift{:>2} - Status {:<23} - Effort{:>20}\n", (int)result.first, result.second, effort);
+                  return BuggerStatus::kOkay;
+               }
+            }
+            if( parameters.minimize_effort )
+            {
+               // reproductions are only kept if they accelerate the solve by the margin
+               if( effort_bound >= 0 && ( effort < 0 || effort >= effort_bound
+                || (double)effort > ( 1.0 - parameters.effort_margin ) * (double)effort_bound ) )
+               {
+                  msg.info("\tSlow{:>3} - Status {:<23} - Effort{:>20}\n", (int)result.first, result.second, effort);
+                  return BuggerStatus::kOkay;
+               }
+               if( effort >= 0 )
+                  effort_bound = effort;
+            }
             if( effort >= 0 )
                last_effort = effort;
             last_result = result;
@@ -236,14 +804,6 @@ namespace bugger
             }
          }
       }
-
-      void apply_changes(Problem<REAL>& copy, const Vec<MatrixEntry<REAL>>& entries) const
-      {
-         MatrixBuffer<REAL> matrixBuffer { };
-         for( const auto &entry: entries )
-            matrixBuffer.addEntry(entry.row, entry.col, entry.val);
-         copy.getConstraintMatrix( ).changeCoefficients(matrixBuffer);
-      }
    };
 
 } // namespace bugger
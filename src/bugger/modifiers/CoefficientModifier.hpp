@@ -44,6 +44,12 @@ namespace bugger
 
    private:
 
+      struct Batch
+      {
+         ScratchVec<Triplet<REAL>> entries { };
+         long long nsides = 0;
+      };
+
       bool
       isFixingAdmissible(const Problem<REAL>& problem, const int& col) const
       {
@@ -79,124 +85,95 @@ namespace bugger
                   ++batchsize;
             if( batchsize == this->parameters.nbatches - 1 )
                return ModifierStatus::kNotAdmissible;
-            batchsize /= this->parameters.nbatches;
+            batchsize = this->predict_batchsize(problem, batchsize - this->parameters.nbatches + 1,
+                                                batchsize / this->parameters.nbatches, CostModel<REAL>::Shrink::kNone);
          }
 
-         bool admissible = false;
-         auto copy = Problem<REAL>(problem);
-         auto& matrix = copy.getConstraintMatrix( );
-         Vec<MatrixEntry<REAL>> applied_entries { };
-         Vec<std::pair<int, REAL>> applied_lefts { };
-         Vec<std::pair<int, REAL>> applied_rights { };
-         Vec<MatrixEntry<REAL>> batches_coeff { };
-         Vec<std::pair<int, REAL>> batches_lhs { };
-         Vec<std::pair<int, REAL>> batches_rhs { };
-         batches_lhs.reserve(batchsize);
-         batches_rhs.reserve(batchsize);
-         int batch = 0;
-
-         for( int row = copy.getNRows( ) - 1; row >= 0; --row )
-         {
-            if( isCoefficientAdmissible(copy, row) )
-            {
-               admissible = true;
-               const auto& data = matrix.getRowCoefficients(row);
-               bool integral = true;
-               REAL offset { };
-               for( int index = data.getLength( ) - 1; index >= 0; --index )
-               {
-                  int col = data.getIndices( )[ index ];
-                  REAL val = data.getValues( )[ index ];
-                  if( !this->num.isZetaZero(val) && isFixingAdmissible(copy, col) )
+         Vec<Triplet<REAL>> applied_entries { };
+         long long applied_sides = 0;
+         ModifierStatus status = this->template apply_batches<Batch>(settings, problem, solution, problem.getNRows( ), batchsize,
+               [this, &solution](Problem<REAL>& copy, int element, Batch& batch) {
+                  int row = copy.getNRows( ) - 1 - element;
+                  if( !isCoefficientAdmissible(copy, row) )
+                     return false;
+                  auto& matrix = copy.getConstraintMatrix( );
+                  const auto& data = matrix.getRowCoefficients(row);
+                  bool integral = true;
+                  REAL offset { };
+                  for( int index = data.getLength( ) - 1; index >= 0; --index )
                   {
-                     REAL fixedval { };
-                     if( solution.status == SolutionStatus::kFeasible )
+                     int col = data.getIndices( )[ index ];
+                     REAL val = data.getValues( )[ index ];
+                     if( !this->num.isZetaZero(val) && isFixingAdmissible(copy, col) )
                      {
-                        fixedval = solution.primal[ col ];
-                        if( copy.getColFlags( )[ col ].test(ColFlag::kIntegral) )
-                           fixedval = round(fixedval);
-                     }
-                     else
-                     {
-                        if( copy.getColFlags( )[ col ].test(ColFlag::kIntegral) )
+                        REAL fixedval { };
+                        if( solution.status == SolutionStatus::kFeasible )
                         {
-                           if( !copy.getColFlags( )[ col ].test(ColFlag::kUbInf) )
-                              fixedval = min(fixedval, this->num.epsFloor(copy.getUpperBounds( )[ col ]));
-                           if( !copy.getColFlags( )[ col ].test(ColFlag::kLbInf) )
-                              fixedval = max(fixedval, this->num.epsCeil(copy.getLowerBounds( )[ col ]));
+                           fixedval = solution.primal[ col ];
+                           if( copy.getColFlags( )[ col ].test(ColFlag::kIntegral) )
+                              fixedval = round(fixedval);
                         }
                         else
                         {
-                           if( !copy.getColFlags( )[ col ].test(ColFlag::kUbInf) )
-                              fixedval = min(fixedval, copy.getUpperBounds( )[ col ]);
-                           if( !copy.getColFlags( )[ col ].test(ColFlag::kLbInf) )
-                              fixedval = max(fixedval, copy.getLowerBounds( )[ col ]);
+                           if( copy.getColFlags( )[ col ].test(ColFlag::kIntegral) )
+                           {
+                              if( !copy.getColFlags( )[ col ].test(ColFlag::kUbInf) )
+                                 fixedval = min(fixedval, this->num.epsFloor(copy.getUpperBounds( )[ col ]));
+                              if( !copy.getColFlags( )[ col ].test(ColFlag::kLbInf) )
+                                 fixedval = max(fixedval, this->num.epsCeil(copy.getLowerBounds( )[ col ]));
+                           }
+                           else
+                           {
+                              if( !copy.getColFlags( )[ col ].test(ColFlag::kUbInf) )
+                                 fixedval = min(fixedval, copy.getUpperBounds( )[ col ]);
+                              if( !copy.getColFlags( )[ col ].test(ColFlag::kLbInf) )
+                                 fixedval = max(fixedval, copy.getLowerBounds( )[ col ]);
+                           }
                         }
+                        offset -= val * fixedval;
+                        batch.entries.emplace_back(row, col, 0);
                      }
-                     offset -= val * fixedval;
-                     batches_coeff.emplace_back(row, col, 0);
+                     else if( !copy.getColFlags( )[ col ].test(ColFlag::kFixed) && ( !copy.getColFlags( )[ col ].test(ColFlag::kIntegral) || !this->num.isEpsIntegral(val) ) )
+                        integral = false;
                   }
-                  else if( !copy.getColFlags( )[ col ].test(ColFlag::kFixed) && ( !copy.getColFlags( )[ col ].test(ColFlag::kIntegral) || !this->num.isEpsIntegral(val) ) )
-                     integral = false;
-               }
-               if( !copy.getRowFlags( )[ row ].test(RowFlag::kLhsInf) )
-               {
-                  REAL lhs { matrix.getLeftHandSides( )[ row ] + offset };
-                  if( integral )
-                     lhs = round(lhs);
-                  if( !this->num.isZetaEq(matrix.getLeftHandSides( )[ row ], lhs) )
+                  if( !copy.getRowFlags( )[ row ].test(RowFlag::kLhsInf) )
                   {
-                     matrix.modifyLeftHandSide(row, this->num, lhs);
-                     batches_lhs.emplace_back(row, lhs);
+                     REAL lhs { matrix.getLeftHandSides( )[ row ] + offset };
+                     if( integral )
+                        lhs = round(lhs);
+                     if( !this->num.isZetaEq(matrix.getLeftHandSides( )[ row ], lhs) )
+                     {
+                        matrix.modifyLeftHandSide(row, this->num, lhs);
+                        ++batch.nsides;
+                     }
                   }
-               }
-               if( !copy.getRowFlags( )[ row ].test(RowFlag::kRhsInf) )
-               {
-                  REAL rhs { matrix.getRightHandSides( )[ row ] + offset };
-                  if( integral )
-                     rhs = round(rhs);
-                  if( !this->num.isZetaEq(matrix.getRightHandSides( )[ row ], rhs) )
+                  if( !copy.getRowFlags( )[ row ].test(RowFlag::kRhsInf) )
                   {
-                     matrix.modifyRightHandSide(row, this->num, rhs);
-                     batches_rhs.emplace_back(row, rhs);
+                     REAL rhs { matrix.getRightHandSides( )[ row ] + offset };
+                     if( integral )
+                        rhs = round(rhs);
+                     if( !this->num.isZetaEq(matrix.getRightHandSides( )[ row ], rhs) )
+                     {
+                        matrix.modifyRightHandSide(row, this->num, rhs);
+                        ++batch.nsides;
+                     }
                   }
-               }
-               ++batch;
-            }
-
-            if( batch >= 1 && ( batch >= batchsize || row <= 0 ) )
-            {
-               this->apply_changes(copy, batches_coeff);
-               if( this->call_solver(settings, copy, solution) == BuggerStatus::kOkay )
-               {
-                  copy = Problem<REAL>(problem);
-                  this->apply_changes(copy, applied_entries);
-                  for( const auto& item: applied_lefts )
-                     matrix.modifyLeftHandSide( item.first, this->num, item.second );
-                  for( const auto& item: applied_rights )
-                     matrix.modifyRightHandSide( item.first, this->num, item.second );
-               }
-               else
-               {
-                  applied_entries.insert(applied_entries.end(), batches_coeff.begin(), batches_coeff.end());
-                  applied_lefts.insert(applied_lefts.end(), batches_lhs.begin(), batches_lhs.end());
-                  applied_rights.insert(applied_rights.end(), batches_rhs.begin(), batches_rhs.end());
-               }
-               batches_coeff.clear();
-               batches_lhs.clear();
-               batches_rhs.clear();
-               batch = 0;
-            }
+                  return true;
+               },
+               [&applied_entries, &applied_sides](const Batch& batch) {
+                  applied_entries.insert(applied_entries.end(), batch.entries.begin(), batch.entries.end());
+                  applied_sides += batch.nsides;
+               },
+               [this](Problem<REAL>& copy, Batch& batch) {
+                  copy.getConstraintMatrix( ).changeCoefficients(batch.entries);
+               });
+
+         if( status == ModifierStatus::kSuccessful )
+         {
+            this->nchgcoefs += applied_entries.size();
+            this->nchgsides += applied_sides;
          }
-
-         if( !admissible )
-            return ModifierStatus::kNotAdmissible;
-         if( applied_entries.empty() )
-            return ModifierStatus::kUnsuccesful;
-         problem = copy;
-         this->nchgcoefs += applied_entries.size();
-         this->nchgsides += applied_lefts.size() + applied_rights.size();
-         return ModifierStatus::kSuccessful;
+         return status;
       }
    };
 
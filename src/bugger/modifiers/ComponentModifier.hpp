@@ -0,0 +1,203 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BUGGER_MODIFIERS_COMPONENTMODIFIER_HPP__
+#define __BUGGER_MODIFIERS_COMPONENTMODIFIER_HPP__
+
+#include "bugger/modifiers/BuggerModifier.hpp"
+
+
+namespace bugger
+{
+   /**
+    * drops independent blocks of the problem at once
+    * the connected components of the graph of the active rows and columns are removed by declaring their rows
+    * redundant and fixing their columns to reference values, where larger components are tried first
+    */
+   template <typename REAL>
+   class ComponentModifier : public BuggerModifier<REAL>
+   {
+   public:
+
+      explicit ComponentModifier(const Message& _msg, const Num<REAL>& _num, const BuggerParameters& _parameters,
+                              std::shared_ptr<SolverFactory<REAL>>& _factory)
+                              : BuggerModifier<REAL>(_msg, _num, _parameters, _factory)
+      {
+         this->setName("component");
+      }
+
+   private:
+
+      struct Component
+      {
+         Vec<int> rows { };
+         Vec<int> cols { };
+      };
+
+      struct Batch
+      {
+         int nrows = 0;
+         int ncols = 0;
+      };
+
+      static int
+      find(Vec<int>& parents, int col)
+      {
+         while( parents[ col ] != col )
+         {
+            parents[ col ] = parents[ parents[ col ] ];
+            col = parents[ col ];
+         }
+         return col;
+      }
+
+      Vec<Component>
+      getComponents(const Problem<REAL>& problem) const
+      {
+         const auto& matrix = problem.getConstraintMatrix( );
+         const auto& rflags = problem.getRowFlags( );
+         const auto& cflags = problem.getColFlags( );
+         Vec<int> parents(problem.getNCols( ));
+         for( int col = 0; col < problem.getNCols( ); ++col )
+            parents[ col ] = col;
+         Vec<int> representatives(problem.getNRows( ), -1);
+         for( int row = 0; row < problem.getNRows( ); ++row )
+         {
+            if( rflags[ row ].test(RowFlag::kRedundant) )
+               continue;
+            const auto& row_data = matrix.getRowCoefficients(row);
+            for( int index = 0; index < row_data.getLength( ); ++index )
+            {
+               int col = row_data.getIndices( )[ index ];
+               if( cflags[ col ].test(ColFlag::kFixed) )
+                  continue;
+               if( representatives[ row ] < 0 )
+                  representatives[ row ] = col;
+               else
+               {
+                  int first = find(parents, representatives[ row ]);
+                  int second = find(parents, col);
+                  if( first != second )
+                     parents[ max(first, second) ] = min(first, second);
+               }
+            }
+         }
+         Vec<Component> components { };
+         Vec<int> indices(problem.getNCols( ), -1);
+         for( int col = 0; col < problem.getNCols( ); ++col )
+         {
+            if( cflags[ col ].test(ColFlag::kFixed) )
+               continue;
+            int root = find(parents, col);
+            if( indices[ root ] < 0 )
+            {
+               indices[ root ] = components.size( );
+               components.emplace_back( );
+            }
+            components[ indices[ root ] ].cols.push_back(col);
+         }
+         for( int row = 0; row < problem.getNRows( ); ++row )
+         {
+            if( rflags[ row ].test(RowFlag::kRedundant) )
+               continue;
+            if( representatives[ row ] < 0 )
+            {
+               components.emplace_back( );
+               components.back( ).rows.push_back(row);
+            }
+            else
+               components[ indices[ find(parents, representatives[ row ]) ] ].rows.push_back(row);
+         }
+         std::stable_sort(components.begin( ), components.end( ), [](const Component& left, const Component& right) {
+            return left.rows.size( ) + left.cols.size( ) > right.rows.size( ) + right.cols.size( );
+         });
+         return components;
+      }
+
+      ModifierStatus
+      execute(SolverSettings& settings, Problem<REAL>& problem, Solution<REAL>& solution) override
+      {
+         if( solution.status == SolutionStatus::kInfeasible || solution.status == SolutionStatus::kUnbounded )
+            return ModifierStatus::kNotAdmissible;
+
+         Vec<Component> components = getComponents(problem);
+         if( components.size( ) <= 1 )
+            return ModifierStatus::kNotAdmissible;
+
+         // the components change between rounds so that they are identified by their smallest row or else column
+         Vec<int> keys(components.size( ));
+         for( int element = 0; element < (int)components.size( ); ++element )
+            keys[ element ] = components[ element ].rows.empty( ) ? problem.getNRows( ) + components[ element ].cols.front( )
+                                                                  : components[ element ].rows.front( );
+         this->set_history_keys(std::move(keys));
+
+         long long batchsize = 1;
+
+         if( this->parameters.nbatches > 0 )
+         {
+            batchsize = this->parameters.nbatches - 1 + (long long)components.size( );
+            batchsize = this->predict_batchsize(problem, components.size( ), batchsize / this->parameters.nbatches,
+                                                CostModel<REAL>::Shrink::kNone);
+         }
+
+         Batch applied_reductions { };
+         ModifierStatus status = this->template apply_batches<Batch>(settings, problem, solution, components.size( ), batchsize,
+               [this, &solution, &components](Problem<REAL>& copy, int element, Batch& batch) {
+                  const Component& component = components[ element ];
+                  for( int row: component.rows )
+                  {
+                     assert(!copy.getRowFlags( )[ row ].test(RowFlag::kRedundant));
+                     copy.getRowFlags( )[ row ].set(RowFlag::kRedundant);
+                  }
+                  for( int col: component.cols )
+                  {
+                     assert(!copy.getColFlags( )[ col ].test(ColFlag::kFixed));
+                     REAL fixedval = this->get_fixed_value(copy, solution, col);
+                     copy.getColFlags( )[ col ].unset(ColFlag::kLbInf);
+                     copy.getColFlags( )[ col ].unset(ColFlag::kUbInf);
+                     copy.getLowerBounds( )[ col ] = fixedval;
+                     copy.getUpperBounds( )[ col ] = fixedval;
+                     copy.getColFlags( )[ col ].set(ColFlag::kFixed);
+                  }
+                  batch.nrows += component.rows.size( );
+                  batch.ncols += component.cols.size( );
+                  return true;
+               },
+               [&applied_reductions](const Batch& batch) {
+                  applied_reductions.nrows += batch.nrows;
+                  applied_reductions.ncols += batch.ncols;
+               });
+
+         if( status == ModifierStatus::kSuccessful )
+         {
+            this->ndeletedrows += applied_reductions.nrows;
+            this->nfixedvars += applied_reductions.ncols;
+         }
+         return status;
+      }
+   };
+
+} // namespace bugger
+
+#endif
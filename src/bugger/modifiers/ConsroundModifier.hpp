@@ -44,6 +44,12 @@ namespace bugger
 
    private:
 
+      struct Batch
+      {
+         ScratchVec<Triplet<REAL>> entries { };
+         long long nsides = 0;
+      };
+
       bool
       isConsroundAdmissible(const Problem<REAL>& problem, const int& row) const
       {
@@ -80,87 +86,58 @@ namespace bugger
                   ++batchsize;
             if( batchsize == this->parameters.nbatches - 1 )
                return ModifierStatus::kNotAdmissible;
-            batchsize /= this->parameters.nbatches;
-         }
-
-         bool admissible = false;
-         auto copy = Problem<REAL>(problem);
-         auto& matrix = copy.getConstraintMatrix( );
-         Vec<MatrixEntry<REAL>> applied_entries { };
-         Vec<std::pair<int, REAL>> applied_lefts { };
-         Vec<std::pair<int, REAL>> applied_rights { };
-         Vec<MatrixEntry<REAL>> batches_coeff { };
-         Vec<std::pair<int, REAL>> batches_lhs { };
-         Vec<std::pair<int, REAL>> batches_rhs { };
-         batches_lhs.reserve(batchsize);
-         batches_rhs.reserve(batchsize);
-         int batch = 0;
-
-         for( int row = 0; row < copy.getNRows( ); ++row )
-         {
-            if( isConsroundAdmissible(copy, row) )
-            {
-               admissible = true;
-               const auto& data = matrix.getRowCoefficients(row);
-               REAL lhs { round(matrix.getLeftHandSides( )[ row ]) };
-               REAL rhs { round(matrix.getRightHandSides( )[ row ]) };
-               for( int index = 0; index < data.getLength( ); ++index )
-               {
-                  if( !this->num.isZetaIntegral(data.getValues( )[ index ]) )
-                     batches_coeff.emplace_back(row, data.getIndices( )[ index ], round(data.getValues( )[ index ]));
-               }
-               if( solution.status == SolutionStatus::kFeasible )
-               {
-                  REAL activity { copy.getPrimalActivity(solution, row, true) };
-                  lhs = min(lhs, this->num.epsFloor(activity));
-                  rhs = max(rhs, this->num.epsCeil(activity));
-               }
-               if( !copy.getRowFlags( )[ row ].test(RowFlag::kLhsInf) && !this->num.isZetaEq(matrix.getLeftHandSides()[ row ], lhs) )
-               {
-                  matrix.modifyLeftHandSide(row, this->num, lhs);
-                  batches_lhs.emplace_back(row, lhs);
-               }
-               if( !copy.getRowFlags( )[ row ].test(RowFlag::kRhsInf) && !this->num.isZetaEq(matrix.getRightHandSides()[ row ], rhs) )
-               {
-                  matrix.modifyRightHandSide(row, this->num, rhs);
-                  batches_rhs.emplace_back(row, rhs);
-               }
-               ++batch;
-            }
-
-            if( batch >= 1 && ( batch >= batchsize || row >= copy.getNRows( ) - 1 ) )
-            {
-               this->apply_changes(copy, batches_coeff);
-               if( this->call_solver(settings, copy, solution) == BuggerStatus::kOkay )
-               {
-                  copy = Problem<REAL>(problem);
-                  this->apply_changes(copy, applied_entries);
-                  for( const auto& item: applied_lefts )
-                     matrix.modifyLeftHandSide( item.first, this->num, item.second );
-                  for( const auto& item: applied_rights )
-                     matrix.modifyRightHandSide( item.first, this->num, item.second );
-               }
-               else
-               {
-                  applied_entries.insert(applied_entries.end(), batches_coeff.begin(), batches_coeff.end());
-                  applied_lefts.insert(applied_lefts.end(), batches_lhs.begin(), batches_lhs.end());
-                  applied_rights.insert(applied_rights.end(), batches_rhs.begin(), batches_rhs.end());
-               }
-               batches_coeff.clear();
-               batches_lhs.clear();
-               batches_rhs.clear();
-               batch = 0;
-            }
+            batchsize = this->predict_batchsize(problem, batchsize - this->parameters.nbatches + 1,
+                                                batchsize / this->parameters.nbatches, CostModel<REAL>::Shrink::kNone);
          }
 
-         if( !admissible )
-            return ModifierStatus::kNotAdmissible;
-         if( applied_entries.empty() && applied_lefts.empty() && applied_rights.empty() )
+         Vec<Triplet<REAL>> applied_entries { };
+         long long applied_sides = 0;
+         ModifierStatus status = this->template apply_batches<Batch>(settings, problem, solution, problem.getNRows( ), batchsize,
+               [this, &solution](Problem<REAL>& copy, int row, Batch& batch) {
+                  if( !isConsroundAdmissible(copy, row) )
+                     return false;
+                  auto& matrix = copy.getConstraintMatrix( );
+                  const auto& data = matrix.getRowCoefficients(row);
+                  REAL lhs { round(matrix.getLeftHandSides( )[ row ]) };
+                  REAL rhs { round(matrix.getRightHandSides( )[ row ]) };
+                  for( int index = 0; index < data.getLength( ); ++index )
+                  {
+                     if( !this->num.isZetaIntegral(data.getValues( )[ index ]) )
+                        batch.entries.emplace_back(row, data.getIndices( )[ index ], round(data.getValues( )[ index ]));
+                  }
+                  if( solution.status == SolutionStatus::kFeasible )
+                  {
+                     REAL activity { copy.getPrimalActivity(solution, row, true) };
+                     lhs = min(lhs, this->num.epsFloor(activity));
+                     rhs = max(rhs, this->num.epsCeil(activity));
+                  }
+                  if( !copy.getRowFlags( )[ row ].test(RowFlag::kLhsInf) && !this->num.isZetaEq(matrix.getLeftHandSides()[ row ], lhs) )
+                  {
+                     matrix.modifyLeftHandSide(row, this->num, lhs);
+                     ++batch.nsides;
+                  }
+                  if( !copy.getRowFlags( )[ row ].test(RowFlag::kRhsInf) && !this->num.isZetaEq(matrix.getRightHandSides()[ row ], rhs) )
+                  {
+                     matrix.modifyRightHandSide(row, this->num, rhs);
+                     ++batch.nsides;
+                  }
+                  return true;
+               },
+               [&applied_entries, &applied_sides](const Batch& batch) {
+                  applied_entries.insert(applied_entries.end(), batch.entries.begin(), batch.entries.end());
+                  applied_sides += batch.nsides;
+               },
+               [this](Problem<REAL>& copy, Batch& batch) {
+                  copy.getConstraintMatrix( ).changeCoefficients(batch.entries);
+               });
+
+         if( status != ModifierStatus::kSuccessful )
+            return status;
+         if( applied_entries.empty() && applied_sides == 0 )
             return ModifierStatus::kUnsuccesful;
-         problem = copy;
          this->nchgcoefs += applied_entries.size();
-         this->nchgsides += applied_lefts.size() + applied_rights.size();
-         return ModifierStatus::kSuccessful;
+         this->nchgsides += applied_sides;
+         return status;
       }
    };
 
@@ -26,6 +26,7 @@
 #define __BUGGER_MODIFIERS_CONSTRAINTMODIFIER_HPP__
 
 #include "bugger/modifiers/BuggerModifier.hpp"
+#include "bugger/data/GraphPartition.hpp"
 
 
 namespace bugger
@@ -44,6 +45,17 @@ namespace bugger
 
    private:
 
+      bool partition = true;
+
+      void
+      addModifierParameters(ParameterSet& paramSet) override
+      {
+         paramSet.addParameter(
+               fmt::format("{}.partition", this->getName( )).c_str( ),
+               "form batches from a partition of the constraint variable graph instead of index ranges",
+               partition);
+      }
+
       bool
       isConstraintAdmissible(const Problem<REAL>& problem, const int& row) const
       {
@@ -68,49 +80,35 @@ namespace bugger
                   ++batchsize;
             if( batchsize == this->parameters.nbatches - 1 )
                return ModifierStatus::kNotAdmissible;
-            batchsize /= this->parameters.nbatches;
+            batchsize = this->predict_batchsize(problem, batchsize - this->parameters.nbatches + 1,
+                                                batchsize / this->parameters.nbatches, CostModel<REAL>::Shrink::kRows);
          }
 
-         bool admissible = false;
-         auto copy = Problem<REAL>(problem);
-         Vec<int> applied_reductions { };
-         Vec<int> batches { };
-         batches.reserve(batchsize);
-
-         for( int row = copy.getNRows( ) - 1; row >= 0; --row )
+         Vec<int> order { };
+         if( partition )
          {
-            if( isConstraintAdmissible(copy, row) )
-            {
-               admissible = true;
-               assert(!copy.getRowFlags( )[ row ].test(RowFlag::kRedundant));
-               copy.getRowFlags( )[ row ].set(RowFlag::kRedundant);
-               batches.push_back(row);
-            }
-
-            if( !batches.empty() && ( batches.size() >= batchsize || row <= 0 ) )
-            {
-               if( this->call_solver(settings, copy, solution) == BuggerStatus::kOkay )
-               {
-                  copy = Problem<REAL>(problem);
-                  for( const auto& item: applied_reductions )
-                  {
-                     assert(!copy.getRowFlags( )[ item ].test(RowFlag::kRedundant));
-                     copy.getRowFlags( )[ item ].set(RowFlag::kRedundant);
-                  }
-               }
-               else
-                  applied_reductions.insert(applied_reductions.end(), batches.begin(), batches.end());
-               batches.clear();
-            }
+            order = GraphPartition<REAL>::getRowOrder(problem);
+            // the partition changes between rounds so that elements are identified by their index
+            this->set_history_keys(order);
          }
-
-         if( !admissible )
-            return ModifierStatus::kNotAdmissible;
-         if( applied_reductions.empty() )
-            return ModifierStatus::kUnsuccesful;
-         problem = copy;
-         this->ndeletedrows += applied_reductions.size();
-         return ModifierStatus::kSuccessful;
+         Vec<int> applied_reductions { };
+         ModifierStatus status = this->template apply_batches<ScratchVec<int>>(settings, problem, solution, problem.getNRows( ), batchsize,
+               [this, &order](Problem<REAL>& copy, int element, ScratchVec<int>& batch) {
+                  int row = order.empty( ) ? copy.getNRows( ) - 1 - element : order[ element ];
+                  if( !isConstraintAdmissible(copy, row) )
+                     return false;
+                  assert(!copy.getRowFlags( )[ row ].test(RowFlag::kRedundant));
+                  copy.getRowFlags( )[ row ].set(RowFlag::kRedundant);
+                  batch.push_back(row);
+                  return true;
+               },
+               [&applied_reductions](const ScratchVec<int>& batch) {
+                  applied_reductions.insert(applied_reductions.end(), batch.begin(), batch.end());
+               });
+
+         if( status == ModifierStatus::kSuccessful )
+            this->ndeletedrows += applied_reductions.size();
+         return status;
       }
    };
 
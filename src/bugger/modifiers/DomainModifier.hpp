@@ -0,0 +1,164 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BUGGER_MODIFIERS_DOMAINMODIFIER_HPP__
+#define __BUGGER_MODIFIERS_DOMAINMODIFIER_HPP__
+
+#include "bugger/modifiers/BuggerModifier.hpp"
+
+
+namespace bugger
+{
+   template <typename REAL>
+   class DomainModifier : public BuggerModifier<REAL>
+   {
+   public:
+
+      explicit DomainModifier(const Message& _msg, const Num<REAL>& _num, const BuggerParameters& _parameters,
+                              std::shared_ptr<SolverFactory<REAL>>& _factory)
+                              : BuggerModifier<REAL>(_msg, _num, _parameters, _factory)
+      {
+         this->setName("domain");
+      }
+
+   private:
+
+      /**
+       * moves a bound halfway to the center, where integral distances are rounded down and tiny distances vanish
+       * @param bound
+       * @param center
+       * @param integral
+       */
+      REAL
+      shrink(const REAL& bound, const REAL& center, bool integral) const
+      {
+         REAL distance { ( bound - center ) / 2 };
+         if( integral )
+            distance = distance >= 0 ? this->num.epsFloor(distance) : this->num.epsCeil(distance);
+         if( this->num.isFeasZero(distance) )
+            return center;
+         return center + distance;
+      }
+
+      /**
+       * computes the shrunk domain of a column, where infinite bounds become finite at the distance of the opposite
+       * bound or else one more than the magnitude of the center and finite bounds halve their distance to the center
+       * @param problem
+       * @param solution
+       * @param col
+       * @param lb new lower bound
+       * @param ub new upper bound
+       * @return whether the domain shrinks
+       */
+      bool
+      getShrunkDomain(const Problem<REAL>& problem, const Solution<REAL>& solution, const int& col, REAL& lb, REAL& ub) const
+      {
+         if( problem.getColFlags( )[ col ].test(ColFlag::kFixed) )
+            return false;
+         bool lbinf = problem.getColFlags( )[ col ].test(ColFlag::kLbInf);
+         bool ubinf = problem.getColFlags( )[ col ].test(ColFlag::kUbInf);
+         bool integral = problem.getColFlags( )[ col ].test(ColFlag::kIntegral);
+         lb = problem.getLowerBounds( )[ col ];
+         ub = problem.getUpperBounds( )[ col ];
+         REAL center { this->get_fixed_value(problem, solution, col) };
+         if( lbinf || ubinf )
+         {
+            REAL distance { abs(center) + 1 };
+            if( !lbinf )
+               distance = max(center - lb, REAL(1));
+            else if( !ubinf )
+               distance = max(ub - center, REAL(1));
+            if( integral )
+               distance = this->num.epsCeil(distance);
+            if( lbinf )
+               lb = center - distance;
+            if( ubinf )
+               ub = center + distance;
+            return true;
+         }
+         REAL newlb { max(shrink(lb, center, integral), lb) };
+         REAL newub { min(shrink(ub, center, integral), ub) };
+         if( !this->num.isZetaGT(newlb, lb) && !this->num.isZetaLT(newub, ub) )
+            return false;
+         lb = newlb;
+         ub = newub;
+         return true;
+      }
+
+      ModifierStatus
+      execute(SolverSettings& settings, Problem<REAL>& problem, Solution<REAL>& solution) override
+      {
+         if( solution.status == SolutionStatus::kUnbounded )
+            return ModifierStatus::kNotAdmissible;
+
+         long long batchsize = 1;
+
+         if( this->parameters.nbatches > 0 )
+         {
+            batchsize = this->parameters.nbatches - 1;
+            REAL lb { };
+            REAL ub { };
+            for( int i = 0; i < problem.getNCols( ); ++i )
+               if( getShrunkDomain(problem, solution, i, lb, ub) )
+                  ++batchsize;
+            if( batchsize == this->parameters.nbatches - 1 )
+               return ModifierStatus::kNotAdmissible;
+            batchsize = this->predict_batchsize(problem, batchsize - this->parameters.nbatches + 1,
+                                                batchsize / this->parameters.nbatches, CostModel<REAL>::Shrink::kNone);
+         }
+
+         long long applied_changes = 0;
+         ModifierStatus status = this->template apply_batches<long long>(settings, problem, solution, problem.getNCols( ), batchsize,
+               [this, &solution](Problem<REAL>& copy, int col, long long& batch) {
+                  REAL lb { };
+                  REAL ub { };
+                  if( !getShrunkDomain(copy, solution, col, lb, ub) )
+                     return false;
+                  if( copy.getColFlags( )[ col ].test(ColFlag::kLbInf) || !this->num.isZetaEq(copy.getLowerBounds( )[ col ], lb) )
+                  {
+                     copy.getColFlags( )[ col ].unset(ColFlag::kLbInf);
+                     copy.getLowerBounds( )[ col ] = lb;
+                     ++batch;
+                  }
+                  if( copy.getColFlags( )[ col ].test(ColFlag::kUbInf) || !this->num.isZetaEq(copy.getUpperBounds( )[ col ], ub) )
+                  {
+                     copy.getColFlags( )[ col ].unset(ColFlag::kUbInf);
+                     copy.getUpperBounds( )[ col ] = ub;
+                     ++batch;
+                  }
+                  return true;
+               },
+               [&applied_changes](const long long& batch) {
+                  applied_changes += batch;
+               });
+
+         if( status == ModifierStatus::kSuccessful )
+            this->nchgcoefs += applied_changes;
+         return status;
+      }
+   };
+
+} // namespace bugger
+
+#endif
@@ -26,6 +26,7 @@
 #define __BUGGER_MODIFIERS_FIXINGMODIFIER_HPP__
 
 #include "bugger/modifiers/BuggerModifier.hpp"
+#include "bugger/data/GraphPartition.hpp"
 
 
 namespace bugger
@@ -44,6 +45,23 @@ namespace bugger
 
    private:
 
+      bool partition = true;
+
+      void
+      addModifierParameters(ParameterSet& paramSet) override
+      {
+         paramSet.addParameter(
+               fmt::format("{}.partition", this->getName( )).c_str( ),
+               "form batches from a partition of the constraint variable graph instead of index ranges",
+               partition);
+      }
+
+      struct Batch
+      {
+         ScratchVec<int> vars { };
+         ScratchVec<Triplet<REAL>> entries { };
+      };
+
       bool
       isFixingAdmissible(const Problem<REAL>& problem, const int& col) const
       {
@@ -66,138 +84,78 @@ namespace bugger
                   ++batchsize;
             if( batchsize == this->parameters.nbatches - 1 )
                return ModifierStatus::kNotAdmissible;
-            batchsize /= this->parameters.nbatches;
+            batchsize = this->predict_batchsize(problem, batchsize - this->parameters.nbatches + 1,
+                                                batchsize / this->parameters.nbatches, CostModel<REAL>::Shrink::kColumns);
          }
 
-         bool admissible = false;
-         auto copy = Problem<REAL>(problem);
-         Vec<int> applied_reductions { };
-         Vec<MatrixEntry<REAL>> applied_entries { };
-         Vec<std::pair<int, REAL>> applied_lefts { };
-         Vec<std::pair<int, REAL>> applied_rights { };
-         Vec<int> batches_vars { };
-         Vec<MatrixEntry<REAL>> batches_coeff { };
-         Vec<std::pair<int, REAL>> batches_lhs { };
-         Vec<std::pair<int, REAL>> batches_rhs { };
-         batches_vars.reserve(batchsize);
-
-         for( int col = copy.getNCols( ) - 1; col >= 0; --col )
+         Vec<int> order { };
+         if( partition )
          {
-            if( isFixingAdmissible(copy, col) )
-            {
-               admissible = true;
-               const auto& col_data = copy.getConstraintMatrix( ).getColumnCoefficients(col);
-               REAL fixedval { };
-               if( solution.status == SolutionStatus::kFeasible )
-               {
-                  fixedval = solution.primal[ col ];
-                  if( copy.getColFlags( )[ col ].test(ColFlag::kIntegral) )
-                     fixedval = round(fixedval);
-               }
-               else
-               {
-                  if( copy.getColFlags( )[ col ].test(ColFlag::kIntegral) )
-                  {
-                     if( !copy.getColFlags( )[ col ].test(ColFlag::kUbInf) )
-                        fixedval = min(fixedval, this->num.epsFloor(copy.getUpperBounds( )[ col ]));
-                     if( !copy.getColFlags( )[ col ].test(ColFlag::kLbInf) )
-                        fixedval = max(fixedval, this->num.epsCeil(copy.getLowerBounds( )[ col ]));
-                  }
-                  else
-                  {
-                     if( !copy.getColFlags( )[ col ].test(ColFlag::kUbInf) )
-                        fixedval = min(fixedval, copy.getUpperBounds( )[ col ]);
-                     if( !copy.getColFlags( )[ col ].test(ColFlag::kLbInf) )
-                        fixedval = max(fixedval, copy.getLowerBounds( )[ col ]);
-                  }
-               }
-               assert(!copy.getColFlags( )[ col ].test(ColFlag::kFixed));
-               copy.getColFlags( )[ col ].set(ColFlag::kFixed);
-               batches_vars.push_back(col);
-               for( int row_index = col_data.getLength( ) - 1; row_index >= 0; --row_index )
-               {
-                  int row = col_data.getIndices( )[ row_index ];
-                  REAL val = col_data.getValues( )[ row_index ];
-                  if( !this->num.isZetaZero(val) && !copy.getConstraintMatrix( ).getRowFlags( )[ row ].test(RowFlag::kRedundant))
+            order = GraphPartition<REAL>::getColumnOrder(problem);
+            // the partition changes between rounds so that elements are identified by their index
+            this->set_history_keys(order);
+         }
+         Vec<int> applied_reductions { };
+         ModifierStatus status = this->template apply_batches<Batch>(settings, problem, solution, problem.getNCols( ), batchsize,
+               [this, &order, &solution](Problem<REAL>& copy, int element, Batch& batch) {
+                  int col = order.empty( ) ? copy.getNCols( ) - 1 - element : order[ element ];
+                  if( !isFixingAdmissible(copy, col) )
+                     return false;
+                  const auto& col_data = copy.getConstraintMatrix( ).getColumnCoefficients(col);
+                  REAL fixedval { this->get_fixed_value(copy, solution, col) };
+                  assert(!copy.getColFlags( )[ col ].test(ColFlag::kFixed));
+                  copy.getColFlags( )[ col ].set(ColFlag::kFixed);
+                  batch.vars.push_back(col);
+                  for( int row_index = col_data.getLength( ) - 1; row_index >= 0; --row_index )
                   {
-                     const auto& row_data = copy.getConstraintMatrix( ).getRowCoefficients(row);
-                     bool integral = true;
-                     REAL offset { -val * fixedval };
-                     for( int col_index = 0; col_index < row_data.getLength( ); ++col_index )
+                     int row = col_data.getIndices( )[ row_index ];
+                     REAL val = col_data.getValues( )[ row_index ];
+                     if( !this->num.isZetaZero(val) && !copy.getConstraintMatrix( ).getRowFlags( )[ row ].test(RowFlag::kRedundant))
                      {
-                        int index = row_data.getIndices( )[ col_index ];
-                        REAL value = row_data.getValues( )[ col_index ];
-                        if( !copy.getColFlags( )[ index ].test(ColFlag::kFixed) && ( !copy.getColFlags( )[ index ].test(ColFlag::kIntegral) || !this->num.isEpsIntegral(value) ) )
+                        const auto& row_data = copy.getConstraintMatrix( ).getRowCoefficients(row);
+                        bool integral = true;
+                        REAL offset { -val * fixedval };
+                        for( int col_index = 0; col_index < row_data.getLength( ); ++col_index )
                         {
-                           integral = false;
-                           break;
+                           int index = row_data.getIndices( )[ col_index ];
+                           REAL value = row_data.getValues( )[ col_index ];
+                           if( !copy.getColFlags( )[ index ].test(ColFlag::kFixed) && ( !copy.getColFlags( )[ index ].test(ColFlag::kIntegral) || !this->num.isEpsIntegral(value) ) )
+                           {
+                              integral = false;
+                              break;
+                           }
                         }
-                     }
-                     batches_coeff.emplace_back(row, col, 0);
-                     if( !copy.getRowFlags( )[ row ].test(RowFlag::kLhsInf) )
-                     {
-                        REAL lhs { copy.getConstraintMatrix( ).getLeftHandSides( )[ row ] + offset };
-                        if( integral )
-                           lhs = round(lhs);
-                        if( !this->num.isZetaEq(copy.getConstraintMatrix( ).getLeftHandSides( )[ row ], lhs) )
+                        batch.entries.emplace_back(row, col, 0);
+                        if( !copy.getRowFlags( )[ row ].test(RowFlag::kLhsInf) )
                         {
-                           copy.getConstraintMatrix( ).modifyLeftHandSide(row, this->num, lhs);
-                           batches_lhs.emplace_back(row, lhs);
+                           REAL lhs { copy.getConstraintMatrix( ).getLeftHandSides( )[ row ] + offset };
+                           if( integral )
+                              lhs = round(lhs);
+                           if( !this->num.isZetaEq(copy.getConstraintMatrix( ).getLeftHandSides( )[ row ], lhs) )
+                              copy.getConstraintMatrix( ).modifyLeftHandSide(row, this->num, lhs);
                         }
-                     }
-                     if( !copy.getRowFlags( )[ row ].test(RowFlag::kRhsInf) )
-                     {
-                        REAL rhs { copy.getConstraintMatrix( ).getRightHandSides( )[ row ] + offset };
-                        if( integral )
-                           rhs = round(rhs);
-                        if( !this->num.isZetaEq(copy.getConstraintMatrix( ).getRightHandSides( )[ row ], rhs) )
+                        if( !copy.getRowFlags( )[ row ].test(RowFlag::kRhsInf) )
                         {
-                           copy.getConstraintMatrix( ).modifyRightHandSide(row, this->num, rhs);
-                           batches_rhs.emplace_back(row, rhs);
+                           REAL rhs { copy.getConstraintMatrix( ).getRightHandSides( )[ row ] + offset };
+                           if( integral )
+                              rhs = round(rhs);
+                           if( !this->num.isZetaEq(copy.getConstraintMatrix( ).getRightHandSides( )[ row ], rhs) )
+                              copy.getConstraintMatrix( ).modifyRightHandSide(row, this->num, rhs);
                         }
                      }
                   }
-               }
-            }
-
-            if( !batches_vars.empty() && ( batches_vars.size() >= batchsize || col <= 0 ) )
-            {
-               this->apply_changes(copy, batches_coeff);
-               if( this->call_solver(settings, copy, solution) == BuggerStatus::kOkay )
-               {
-                  copy = Problem<REAL>(problem);
-                  for( const auto& item: applied_reductions )
-                  {
-                     assert(!copy.getColFlags( )[ item ].test(ColFlag::kFixed));
-                     copy.getColFlags( )[ item ].set(ColFlag::kFixed);
-                  }
-                  this->apply_changes(copy, applied_entries);
-                  for( const auto& item: applied_lefts )
-                     copy.getConstraintMatrix( ).modifyLeftHandSide( item.first, this->num, item.second );
-                  for( const auto& item: applied_rights )
-                     copy.getConstraintMatrix( ).modifyRightHandSide( item.first, this->num, item.second );
-               }
-               else
-               {
-                  applied_reductions.insert(applied_reductions.end(), batches_vars.begin(), batches_vars.end());
-                  applied_entries.insert(applied_entries.end(), batches_coeff.begin(), batches_coeff.end());
-                  applied_lefts.insert(applied_lefts.end(), batches_lhs.begin(), batches_lhs.end());
-                  applied_rights.insert(applied_rights.end(), batches_rhs.begin(), batches_rhs.end());
-               }
-               batches_vars.clear();
-               batches_coeff.clear();
-               batches_lhs.clear();
-               batches_rhs.clear();
-            }
-         }
+                  return true;
+               },
+               [&applied_reductions](const Batch& batch) {
+                  applied_reductions.insert(applied_reductions.end(), batch.vars.begin(), batch.vars.end());
+               },
+               [](Problem<REAL>& copy, Batch& batch) {
+                  copy.getConstraintMatrix( ).changeCoefficients(batch.entries);
+               });
 
-         if( !admissible )
-            return ModifierStatus::kNotAdmissible;
-         if( applied_reductions.empty() )
-            return ModifierStatus::kUnsuccesful;
-         problem = copy;
-         this->naggrvars += applied_reductions.size();
-         return ModifierStatus::kSuccessful;
+         if( status == ModifierStatus::kSuccessful )
+            this->naggrvars += applied_reductions.size();
+         return status;
       }
    };
 
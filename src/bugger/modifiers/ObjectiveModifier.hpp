@@ -70,45 +70,27 @@ namespace bugger
                   ++batchsize;
             if( batchsize == this->parameters.nbatches - 1 )
                return ModifierStatus::kNotAdmissible;
-            batchsize /= this->parameters.nbatches;
+            batchsize = this->predict_batchsize(problem, batchsize - this->parameters.nbatches + 1,
+                                                batchsize / this->parameters.nbatches, CostModel<REAL>::Shrink::kNone);
          }
 
-         bool admissible = false;
-         auto copy = Problem<REAL>(problem);
          Vec<int> applied_reductions { };
-         Vec<int> batches { };
-         batches.reserve(batchsize);
-
-         for( int col = copy.getNCols( ) - 1; col >= 0; --col )
-         {
-            if( isObjectiveAdmissible(copy, col) )
-            {
-               admissible = true;
-               copy.getObjective( ).coefficients[ col ] = 0;
-               batches.push_back(col);
-            }
-
-            if( !batches.empty() && ( batches.size() >= batchsize || col <= 0 ) )
-            {
-               if( this->call_solver(settings, copy, solution) == BuggerStatus::kOkay )
-               {
-                  copy = Problem<REAL>(problem);
-                  for( const auto& item: applied_reductions )
-                     copy.getObjective( ).coefficients[ item ] = 0;
-               }
-               else
-                  applied_reductions.insert(applied_reductions.end(), batches.begin(), batches.end());
-               batches.clear();
-            }
-         }
-
-         if( !admissible )
-            return ModifierStatus::kNotAdmissible;
-         if( applied_reductions.empty() )
-            return ModifierStatus::kUnsuccesful;
-         problem = copy;
-         this->nchgcoefs += applied_reductions.size();
-         return ModifierStatus::kSuccessful;
+         ModifierStatus status = this->template apply_batches<ScratchVec<int>>(settings, problem, solution, problem.getNCols( ), batchsize,
+               [this](Problem<REAL>& copy, int element, ScratchVec<int>& batch) {
+                  int col = copy.getNCols( ) - 1 - element;
+                  if( !isObjectiveAdmissible(copy, col) )
+                     return false;
+                  copy.getObjective( ).coefficients[ col ] = 0;
+                  batch.push_back(col);
+                  return true;
+               },
+               [&applied_reductions](const ScratchVec<int>& batch) {
+                  applied_reductions.insert(applied_reductions.end(), batch.begin(), batch.end());
+               });
+
+         if( status == ModifierStatus::kSuccessful )
+            this->nchgcoefs += applied_reductions.size();
+         return status;
       }
    };
 
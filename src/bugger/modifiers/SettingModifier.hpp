@@ -26,6 +26,8 @@
 #define __BUGGER_MODIFIERS_SETTINGMODIFIER_HPP__
 
 #include "bugger/modifiers/BuggerModifier.hpp"
+#include <algorithm>
+#include <numeric>
 
 
 namespace bugger
@@ -46,9 +48,62 @@ namespace bugger
 
    private:
 
+      enum class SettingType : int
+      {
+         kBool = 0,
+
+         kInt = 1,
+
+         kLong = 2,
+
+         kDouble = 3,
+
+         kChar = 4,
+
+         kString = 5,
+      };
+
+      /**
+       * setting of any type differing from its target value
+       */
+      struct Difference
+      {
+         SettingType type;
+         int index;
+         String name;
+      };
+
+      /**
+       * state of the search on the name prefix tree of the differing settings
+       */
+      struct Search
+      {
+         const SolverSettings& settings;
+         SolverSettings copy;
+         Problem<REAL>& problem;
+         Solution<REAL>& solution;
+         Vec<Difference> differences;
+         Vec<Difference> applied;
+         bool ordered;
+      };
+
+      bool hierarchical = true;
+
+      void
+      addModifierParameters(ParameterSet& paramSet) override
+      {
+         paramSet.addParameter(
+               fmt::format("{}.hierarchical", this->getName( )).c_str( ),
+               "reset subtrees of the name prefix tree of all settings to target values and descend only into failing subtrees instead of batches by position within each type",
+               hierarchical);
+      }
+
       ModifierStatus
       execute(SolverSettings& settings, Problem<REAL>& problem, Solution<REAL>& solution) override
       {
+         if( hierarchical )
+            return searchPrefixTree(settings, problem, solution);
+
          long long batchsize = 1;
 
          if( this->parameters.nbatches > 0 )
@@ -305,11 +360,265 @@ namespace bugger
             return ModifierStatus::kNotAdmissible;
          if( applied_bool.empty() && applied_int.empty() && applied_long.empty() && applied_double.empty() && applied_char.empty() && applied_string.empty() )
             return ModifierStatus::kUnsuccesful;
+         if( this->reductionlog )
+            this->reductionlog->appendSettings(this->getName( ), copy);
          settings = copy;
          this->nchgsettings += applied_bool.size() + applied_int.size() + applied_long.size() + applied_double.size() + applied_char.size() + applied_string.size();
          return ModifierStatus::kSuccessful;
       }
 
+      /**
+       * resets settings to target values in subtrees of the name prefix tree separated by '/', where the whole tree is
+       * tried first and failing subtrees are bisected over their children and descended into down to single settings
+       * @param settings
+       * @param problem
+       * @param solution
+       * @return status whether any setting differs and any reset was accepted
+       */
+      ModifierStatus
+      searchPrefixTree(SolverSettings& settings, Problem<REAL>& problem, Solution<REAL>& solution)
+      {
+         Search search { settings, SolverSettings(settings), problem, solution, getDifferences(settings), { },
+                         this->follow_history( ) };
+         if( search.differences.empty( ) )
+            return ModifierStatus::kNotAdmissible;
+
+         // order by path components so that every subtree forms a range
+         std::sort(search.differences.begin( ), search.differences.end( ),
+               [](const Difference& left, const Difference& right) {
+                  return std::lexicographical_compare(left.name.begin( ), left.name.end( ), right.name.begin( ), right.name.end( ),
+                        [](char first, char second) {
+                           return ( first == '/' ? 0 : (unsigned char)first + 1 ) < ( second == '/' ? 0 : (unsigned char)second + 1 );
+                        });
+               });
+         Vec<std::pair<int, int>> root { { 0, (int)search.differences.size( ) } };
+         bisect(search, root, 0, 1, 0, false);
+
+         if( search.applied.empty( ) )
+            return ModifierStatus::kUnsuccesful;
+         settings = search.copy;
+         this->nchgsettings += search.applied.size( );
+         return ModifierStatus::kSuccessful;
+      }
+
+      /**
+       * tries to reset the children of a node together and otherwise halves them until single failing children are
+       * descended into, where no further resets are tried once the time limit is reached
+       * @param search
+       * @param children ranges of the differences in the subtrees of the children
+       * @param first first child
+       * @param last past the last child
+       * @param depth depth of the children
+       * @param failed whether the reset of the children is already known to fail
+       */
+      void
+      bisect(Search& search, const Vec<std::pair<int, int>>& children, int first, int last, int depth, bool failed)
+      {
+         if( this->timer != nullptr && this->is_time_exceeded(*this->timer, this->parameters.tlim) )
+            return;
+         if( !failed && applyTargets(search, children, first, last) )
+            return;
+         if( last - first >= 2 )
+         {
+            int middle = first + ( last - first ) / 2;
+            bisect(search, children, first, middle, depth, false);
+            bisect(search, children, middle, last, depth, false);
+         }
+         else if( children[ first ].second - children[ first ].first >= 2 )
+            descend(search, children[ first ].first, children[ first ].second, depth);
+      }
+
+      /**
+       * splits the failing subtree of a node into the subtrees of its children, where chains of single children are
+       * skipped and settings of equal names form separate children
+       * @param search
+       * @param begin first difference in the subtree
+       * @param end past the last difference in the subtree
+       * @param depth depth of the node
+       */
+      void
+      descend(Search& search, int begin, int end, int depth)
+      {
+         Vec<std::pair<int, int>> children { };
+         while( true )
+         {
+            bool deeper = false;
+            children.clear( );
+            for( int i = begin; i < end; )
+            {
+               const String& name = search.differences[ i ].name;
+               auto component = getComponent(name, depth);
+               deeper = deeper || component.second < name.size( );
+               int j = i + 1;
+               while( j < end )
+               {
+                  const String& next = search.differences[ j ].name;
+                  auto other = getComponent(next, depth);
+                  if( name.compare(component.first, component.second - component.first, next, other.first,
+                                   other.second - other.first) != 0 )
+                     break;
+                  ++j;
+               }
+               children.emplace_back(i, j);
+               i = j;
+            }
+            if( children.size( ) >= 2 || !deeper )
+               break;
+            ++depth;
+         }
+         if( children.size( ) == 1 )
+         {
+            children.clear( );
+            for( int i = begin; i < end; ++i )
+               children.emplace_back(i, i + 1);
+         }
+         // group children of many rejected resets at the end so that the others are reset together
+         if( search.ordered )
+         {
+            Vec<int> counts(children.size( ), 0);
+            for( int i = 0; i < (int)children.size( ); ++i )
+               for( int j = children[ i ].first; j < children[ i ].second; ++j )
+                  counts[ i ] = max(counts[ i ], this->history.getCount(getHistoryKey(search.differences[ j ])));
+            Vec<int> order(children.size( ));
+            std::iota(order.begin( ), order.end( ), 0);
+            std::stable_sort(order.begin( ), order.end( ), [&counts](int left, int right) {
+               return counts[ left ] < counts[ right ];
+            });
+            Vec<std::pair<int, int>> sorted { };
+            sorted.reserve(children.size( ));
+            for( int i: order )
+               sorted.push_back(children[ i ]);
+            children = std::move(sorted);
+         }
+         bisect(search, children, 0, (int)children.size( ), depth + 1, true);
+      }
+
+      /**
+       * sets the differences of the given children to target values and keeps them if the issue is preserved
+       * @param search
+       * @param children ranges of the differences in the subtrees of the children
+       * @param first first child
+       * @param last past the last child
+       * @return whether the differences were applied
+       */
+      bool
+      applyTargets(Search& search, const Vec<std::pair<int, int>>& children, int first, int last)
+      {
+         for( int i = first; i < last; ++i )
+            for( int j = children[ i ].first; j < children[ i ].second; ++j )
+               assign(search.copy, search.differences[ j ]);
+         if( this->call_solver(search.copy, search.problem, search.solution) == BuggerStatus::kOkay )
+         {
+            if( this->parameters.history )
+               for( int i = first; i < last; ++i )
+                  for( int j = children[ i ].first; j < children[ i ].second; ++j )
+                     this->history.reject(getHistoryKey(search.differences[ j ]));
+            search.copy = reset(search.settings, search.copy, search.applied);
+            return false;
+         }
+         for( int i = first; i < last; ++i )
+            search.applied.insert(search.applied.end( ), search.differences.begin( ) + children[ i ].first,
+                                  search.differences.begin( ) + children[ i ].second);
+         if( this->reductionlog )
+            this->reductionlog->appendSettings(this->getName( ), search.copy);
+         return true;
+      }
+
+      /**
+       * identifies a setting in the failure history by its type and index
+       * @param difference
+       */
+      static int
+      getHistoryKey(const Difference& difference)
+      {
+         return 6 * difference.index + (int)difference.type;
+      }
+
+      /**
+       * finds the position of a path component in a setting name
+       * @param name
+       * @param depth
+       * @return begin and end of the component, which is empty at the end of the name if the name is shallower
+       */
+      static std::pair<size_t, size_t>
+      getComponent(const String& name, int depth)
+      {
+         size_t begin = 0;
+         for( int i = 0; i < depth; ++i )
+         {
+            begin = name.find('/', begin);
+            if( begin == String::npos )
+               return { name.size( ), name.size( ) };
+            ++begin;
+         }
+         size_t end = name.find('/', begin);
+         return { begin, end == String::npos ? name.size( ) : end };
+      }
+
+      Vec<Difference>
+      getDifferences(const SolverSettings& settings) const
+      {
+         Vec<Difference> differences { };
+         addDifferences(differences, SettingType::kBool, settings.getBoolSettings( ), target_settings.getBoolSettings( ));
+         addDifferences(differences, SettingType::kInt, settings.getIntSettings( ), target_settings.getIntSettings( ));
+         addDifferences(differences, SettingType::kLong, settings.getLongSettings( ), target_settings.getLongSettings( ));
+         addDifferences(differences, SettingType::kDouble, settings.getDoubleSettings( ), target_settings.getDoubleSettings( ));
+         addDifferences(differences, SettingType::kChar, settings.getCharSettings( ), target_settings.getCharSettings( ));
+         addDifferences(differences, SettingType::kString, settings.getStringSettings( ), target_settings.getStringSettings( ));
+         return differences;
+      }
+
+      template <typename T>
+      static void
+      addDifferences(Vec<Difference>& differences, SettingType type, const Vec<std::pair<String, T>>& currents,
+                     const Vec<std::pair<String, T>>& targets)
+      {
+         for( int i = 0; i < (int)targets.size( ); ++i )
+         {
+            assert(targets[ i ].first == currents[ i ].first);
+            if( targets[ i ].second != currents[ i ].second )
+               differences.push_back({ type, i, targets[ i ].first });
+         }
+      }
+
+      void
+      assign(SolverSettings& copy, const Difference& difference) const
+      {
+         switch( difference.type )
+         {
+         case SettingType::kBool:
+            copy.setBoolSettings(difference.index, target_settings.getBoolSettings( )[ difference.index ].second);
+            break;
+         case SettingType::kInt:
+            copy.setIntSettings(difference.index, target_settings.getIntSettings( )[ difference.index ].second);
+            break;
+         case SettingType::kLong:
+            copy.setLongSettings(difference.index, target_settings.getLongSettings( )[ difference.index ].second);
+            break;
+         case SettingType::kDouble:
+            copy.setDoubleSettings(difference.index, target_settings.getDoubleSettings( )[ difference.index ].second);
+            break;
+         case SettingType::kChar:
+            copy.setCharSettings(difference.index, target_settings.getCharSettings( )[ difference.index ].second);
+            break;
+         case SettingType::kString:
+            copy.setStringSettings(difference.index, target_settings.getStringSettings( )[ difference.index ].second);
+            break;
+         }
+      }
+
+      SolverSettings
+      reset(const SolverSettings& settings, const SolverSettings& currents, const Vec<Difference>& applied) const
+      {
+         const auto& limits = currents.getLimitSettings( );
+         auto reset = SolverSettings(settings);
+         for( const auto& difference: applied )
+            assign(reset, difference);
+         for( int i = 0; i < (int)limits.size( ); ++i )
+            reset.setLimitSettings(i, limits[ i ].second);
+         return reset;
+      }
+
       SolverSettings
       reset(const SolverSettings& settings, const SolverSettings& currents,
             const Vec<std::pair<int, bool>>& applied_bool, const Vec<std::pair<int, int>>& applied_int,
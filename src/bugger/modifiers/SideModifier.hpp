@@ -69,84 +69,63 @@ namespace bugger
                   ++batchsize;
             if( batchsize == this->parameters.nbatches - 1 )
                return ModifierStatus::kNotAdmissible;
-            batchsize /= this->parameters.nbatches;
+            batchsize = this->predict_batchsize(problem, batchsize - this->parameters.nbatches + 1,
+                                                batchsize / this->parameters.nbatches, CostModel<REAL>::Shrink::kNone);
          }
 
-         bool admissible = false;
-         auto copy = Problem<REAL>(problem);
-         auto& matrix = copy.getConstraintMatrix( );
          Vec<std::pair<int, REAL>> applied_reductions { };
-         Vec<std::pair<int, REAL>> batches { };
-         batches.reserve(batchsize);
-
-         for( int row = copy.getNRows( ) - 1; row >= 0; --row )
-         {
-            if( isSideAdmissible(copy, row) )
-            {
-               admissible = true;
-               const auto& data = matrix.getRowCoefficients(row);
-               bool integral = true;
-               REAL fixedval { };
-               for( int index = 0; index < data.getLength( ); ++index )
-               {
-                  if( !copy.getColFlags( )[ data.getIndices( )[ index ] ].test(ColFlag::kFixed) && ( !copy.getColFlags( )[ data.getIndices( )[ index ] ].test(ColFlag::kIntegral) || !this->num.isEpsIntegral(data.getValues( )[ index ]) ) )
+         ModifierStatus status = this->template apply_batches<ScratchVec<std::pair<int, REAL>>>(settings, problem, solution, problem.getNRows( ), batchsize,
+               [this, &solution](Problem<REAL>& copy, int element, ScratchVec<std::pair<int, REAL>>& batch) {
+                  int row = copy.getNRows( ) - 1 - element;
+                  if( !isSideAdmissible(copy, row) )
+                     return false;
+                  auto& matrix = copy.getConstraintMatrix( );
+                  const auto& data = matrix.getRowCoefficients(row);
+                  bool integral = true;
+                  REAL fixedval { };
+                  for( int index = 0; index < data.getLength( ); ++index )
                   {
-                     integral = false;
-                     break;
+                     if( !copy.getColFlags( )[ data.getIndices( )[ index ] ].test(ColFlag::kFixed) && ( !copy.getColFlags( )[ data.getIndices( )[ index ] ].test(ColFlag::kIntegral) || !this->num.isEpsIntegral(data.getValues( )[ index ]) ) )
+                     {
+                        integral = false;
+                        break;
+                     }
                   }
-               }
-               if( solution.status == SolutionStatus::kFeasible )
-               {
-                  fixedval = copy.getPrimalActivity(solution, row);
-                  if( integral )
-                     fixedval = round(fixedval);
-               }
-               else
-               {
-                  if( integral )
+                  if( solution.status == SolutionStatus::kFeasible )
                   {
-                     if( !copy.getRowFlags( )[ row ].test(RowFlag::kRhsInf) )
-                        fixedval = min(fixedval, this->num.epsFloor(matrix.getRightHandSides( )[ row ]));
-                     if( !copy.getRowFlags( )[ row ].test(RowFlag::kLhsInf) )
-                        fixedval = max(fixedval, this->num.epsCeil(matrix.getLeftHandSides( )[ row ]));
+                     fixedval = copy.getPrimalActivity(solution, row);
+                     if( integral )
+                        fixedval = round(fixedval);
                   }
                   else
                   {
-                     if( !copy.getRowFlags( )[ row ].test(RowFlag::kRhsInf) )
-                        fixedval = min(fixedval, matrix.getRightHandSides( )[ row ]);
-                     if( !copy.getRowFlags( )[ row ].test(RowFlag::kLhsInf) )
-                        fixedval = max(fixedval, matrix.getLeftHandSides( )[ row ]);
-                  }
-               }
-               matrix.modifyLeftHandSide( row, this->num, fixedval );
-               matrix.modifyRightHandSide( row, this->num, fixedval );
-               batches.emplace_back(row, fixedval);
-            }
-
-            if( !batches.empty() && ( batches.size() >= batchsize || row <= 0 ) )
-            {
-               if( this->call_solver(settings, copy, solution) == BuggerStatus::kOkay )
-               {
-                  copy = Problem<REAL>(problem);
-                  for( const auto& item: applied_reductions )
-                  {
-                     matrix.modifyLeftHandSide( item.first, this->num, item.second );
-                     matrix.modifyRightHandSide( item.first, this->num, item.second );
+                     if( integral )
+                     {
+                        if( !copy.getRowFlags( )[ row ].test(RowFlag::kRhsInf) )
+                           fixedval = min(fixedval, this->num.epsFloor(matrix.getRightHandSides( )[ row ]));
+                        if( !copy.getRowFlags( )[ row ].test(RowFlag::kLhsInf) )
+                           fixedval = max(fixedval, this->num.epsCeil(matrix.getLeftHandSides( )[ row ]));
+                     }
+                     else
+                     {
+                        if( !copy.getRowFlags( )[ row ].test(RowFlag::kRhsInf) )
+                           fixedval = min(fixedval, matrix.getRightHandSides( )[ row ]);
+                        if( !copy.getRowFlags( )[ row ].test(RowFlag::kLhsInf) )
+                           fixedval = max(fixedval, matrix.getLeftHandSides( )[ row ]);
+                     }
                   }
-               }
-               else
-                  applied_reductions.insert(applied_reductions.end(), batches.begin(), batches.end());
-               batches.clear();
-            }
-         }
-
-         if( !admissible )
-            return ModifierStatus::kNotAdmissible;
-         if( applied_reductions.empty() )
-            return ModifierStatus::kUnsuccesful;
-         problem = copy;
-         this->nchgsides += 2 * applied_reductions.size();
-         return ModifierStatus::kSuccessful;
+                  matrix.modifyLeftHandSide( row, this->num, fixedval );
+                  matrix.modifyRightHandSide( row, this->num, fixedval );
+                  batch.emplace_back(row, fixedval);
+                  return true;
+               },
+               [&applied_reductions](const ScratchVec<std::pair<int, REAL>>& batch) {
+                  applied_reductions.insert(applied_reductions.end(), batch.begin(), batch.end());
+               });
+
+         if( status == ModifierStatus::kSuccessful )
+            this->nchgsides += 2 * applied_reductions.size();
+         return status;
       }
    };
 
@@ -0,0 +1,331 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                           */
+/*               This file is part of the program and library                */
+/*                            MIP-DD                                         */
+/*                                                                           */
+/* Copyright (C) 2024             Zuse Institute Berlin                      */
+/*                                                                           */
+/*  Licensed under the Apache License, Version 2.0 (the "License");          */
+/*  you may not use this file except in compliance with the License.         */
+/*  You may obtain a copy of the License at                                  */
+/*                                                                           */
+/*      http://www.apache.org/licenses/LICENSE-2.0                           */
+/*                                                                           */
+/*  Unless required by applicable law or agreed to in writing, software      */
+/*  distributed under the License is distributed on an "AS IS" BASIS,        */
+/*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. */
+/*  See the License for the specific language governing permissions and      */
+/*  limitations under the License.                                           */
+/*                                                                           */
+/*  You should have received a copy of the Apache-2.0 license                */
+/*  along with MIP-DD; see the file LICENSE. If not visit scipopt.org.       */
+/*                                                                           */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BUGGER_MODIFIERS_SIMPLIFYMODIFIER_HPP__
+#define __BUGGER_MODIFIERS_SIMPLIFYMODIFIER_HPP__
+
+#include "bugger/modifiers/BuggerModifier.hpp"
+#include "bugger/misc/Hash.hpp"
+
+
+namespace bugger
+{
+   /**
+    * removes structurally trivial parts of the problem detected by scans of the sparse matrix without any solve
+    * empty rows, rows of fixed columns, singleton rows turned into bounds, duplicate rows merged into one, and columns
+    * in no active row without objective are removed together as a single batch, so that they usually cost one
+    * verification solve at the start of every round instead of many batches of the other modifiers
+    */
+   template <typename REAL>
+   class SimplifyModifier : public BuggerModifier<REAL>
+   {
+   public:
+
+      explicit SimplifyModifier(const Message& _msg, const Num<REAL>& _num, const BuggerParameters& _parameters,
+                             std::shared_ptr<SolverFactory<REAL>>& _factory)
+                             : BuggerModifier<REAL>(_msg, _num, _parameters, _factory)
+      {
+         this->setName("simplify");
+      }
+
+   private:
+
+      struct Batch
+      {
+         int nrows = 0;
+         int ncols = 0;
+      };
+
+      bool
+      isColumnFixed(const Problem<REAL>& problem, int col) const
+      {
+         return !problem.getColFlags( )[ col ].test(ColFlag::kLbInf)
+             && !problem.getColFlags( )[ col ].test(ColFlag::kUbInf)
+             && this->num.isZetaEq(problem.getLowerBounds( )[ col ], problem.getUpperBounds( )[ col ]);
+      }
+
+      /**
+       * declares rows redundant which are empty or only contain fixed columns
+       * @return number of removed rows
+       */
+      int
+      removeFixedRows(Problem<REAL>& problem) const
+      {
+         const auto& matrix = problem.getConstraintMatrix( );
+         int nrows = 0;
+         for( int row = 0; row < problem.getNRows( ); ++row )
+         {
+            if( problem.getRowFlags( )[ row ].test(RowFlag::kRedundant) )
+               continue;
+            const auto& data = matrix.getRowCoefficients(row);
+            bool fixed = true;
+            for( int index = 0; index < data.getLength( ) && fixed; ++index )
+            {
+               int col = data.getIndices( )[ index ];
+               fixed = problem.getColFlags( )[ col ].test(ColFlag::kFixed) || this->num.isZetaZero(data.getValues( )[ index ])
+                       || isColumnFixed(problem, col);
+            }
+            if( fixed )
+            {
+               problem.getRowFlags( )[ row ].set(RowFlag::kRedundant);
+               ++nrows;
+            }
+         }
+         return nrows;
+      }
+
+      /**
+       * turns rows with a single active entry into bounds of its column, which are relaxed to keep the reference
+       * solution feasible
+       * @return number of removed rows
+       */
+      int
+      removeSingletonRows(Problem<REAL>& problem, const Solution<REAL>& solution) const
+      {
+         auto& matrix = problem.getConstraintMatrix( );
+         auto& cflags = problem.getColFlags( );
+         int nrows = 0;
+         for( int row = 0; row < problem.getNRows( ); ++row )
+         {
+            if( problem.getRowFlags( )[ row ].test(RowFlag::kRedundant) )
+               continue;
+            const auto& data = matrix.getRowCoefficients(row);
+            int col = -1;
+            REAL val { };
+            for( int index = 0; index < data.getLength( ); ++index )
+            {
+               if( cflags[ data.getIndices( )[ index ] ].test(ColFlag::kFixed) || this->num.isZetaZero(data.getValues( )[ index ]) )
+                  continue;
+               if( col >= 0 )
+               {
+                  col = -1;
+                  break;
+               }
+               col = data.getIndices( )[ index ];
+               val = data.getValues( )[ index ];
+            }
+            if( col < 0 )
+               continue;
+            bool lbinf = val > 0 ? problem.getRowFlags( )[ row ].test(RowFlag::kLhsInf) : problem.getRowFlags( )[ row ].test(RowFlag::kRhsInf);
+            bool ubinf = val > 0 ? problem.getRowFlags( )[ row ].test(RowFlag::kRhsInf) : problem.getRowFlags( )[ row ].test(RowFlag::kLhsInf);
+            REAL lb { };
+            REAL ub { };
+            if( !lbinf )
+               lb = ( val > 0 ? matrix.getLeftHandSides( )[ row ] : matrix.getRightHandSides( )[ row ] ) / val;
+            if( !ubinf )
+               ub = ( val > 0 ? matrix.getRightHandSides( )[ row ] : matrix.getLeftHandSides( )[ row ] ) / val;
+            if( solution.status == SolutionStatus::kFeasible )
+            {
+               lb = min(lb, solution.primal[ col ]);
+               ub = max(ub, solution.primal[ col ]);
+            }
+            if( cflags[ col ].test(ColFlag::kIntegral) )
+            {
+               lb = this->num.epsCeil(lb);
+               ub = this->num.epsFloor(ub);
+            }
+            // only tighter bounds are applied as long as the domain stays nonempty
+            lbinf = lbinf || ( !cflags[ col ].test(ColFlag::kLbInf) && lb <= problem.getLowerBounds( )[ col ] );
+            ubinf = ubinf || ( !cflags[ col ].test(ColFlag::kUbInf) && ub >= problem.getUpperBounds( )[ col ] );
+            bool haslower = !lbinf || !cflags[ col ].test(ColFlag::kLbInf);
+            bool hasupper = !ubinf || !cflags[ col ].test(ColFlag::kUbInf);
+            if( haslower && hasupper && this->num.isZetaGT(lbinf ? problem.getLowerBounds( )[ col ] : lb,
+                                                           ubinf ? problem.getUpperBounds( )[ col ] : ub) )
+               continue;
+            if( !lbinf )
+            {
+               cflags[ col ].unset(ColFlag::kLbInf);
+               problem.getLowerBounds( )[ col ] = lb;
+            }
+            if( !ubinf )
+            {
+               cflags[ col ].unset(ColFlag::kUbInf);
+               problem.getUpperBounds( )[ col ] = ub;
+            }
+            problem.getRowFlags( )[ row ].set(RowFlag::kRedundant);
+            ++nrows;
+         }
+         return nrows;
+      }
+
+      /**
+       * merges the sides of rows with identical active entries into the first of them
+       * @return number of removed rows
+       */
+      int
+      removeDuplicateRows(Problem<REAL>& problem) const
+      {
+         auto& matrix = problem.getConstraintMatrix( );
+         const auto& cflags = problem.getColFlags( );
+         const auto& rflags = problem.getRowFlags( );
+         Vec<std::pair<std::size_t, int>> keys { };
+         for( int row = 0; row < problem.getNRows( ); ++row )
+         {
+            if( rflags[ row ].test(RowFlag::kRedundant) )
+               continue;
+            const auto& data = matrix.getRowCoefficients(row);
+            Hasher<std::size_t> hasher { };
+            for( int index = 0; index < data.getLength( ); ++index )
+               if( !cflags[ data.getIndices( )[ index ] ].test(ColFlag::kFixed) && !this->num.isZetaZero(data.getValues( )[ index ]) )
+                  hasher.addValue(data.getIndices( )[ index ]);
+            keys.emplace_back(hasher.getHash( ), row);
+         }
+         std::sort(keys.begin( ), keys.end( ));
+         int nrows = 0;
+         for( std::size_t first = 0; first < keys.size( ); ++first )
+         {
+            int row = keys[ first ].second;
+            if( rflags[ row ].test(RowFlag::kRedundant) )
+               continue;
+            for( std::size_t second = first + 1; second < keys.size( ) && keys[ second ].first == keys[ first ].first; ++second )
+            {
+               int duplicate = keys[ second ].second;
+               if( rflags[ duplicate ].test(RowFlag::kRedundant) || !isIdentical(problem, row, duplicate) )
+                  continue;
+               bool lhsinf = rflags[ row ].test(RowFlag::kLhsInf) && rflags[ duplicate ].test(RowFlag::kLhsInf);
+               bool rhsinf = rflags[ row ].test(RowFlag::kRhsInf) && rflags[ duplicate ].test(RowFlag::kRhsInf);
+               REAL lhs { rflags[ row ].test(RowFlag::kLhsInf) ? matrix.getLeftHandSides( )[ duplicate ]
+                        : rflags[ duplicate ].test(RowFlag::kLhsInf) ? matrix.getLeftHandSides( )[ row ]
+                        : max(matrix.getLeftHandSides( )[ row ], matrix.getLeftHandSides( )[ duplicate ]) };
+               REAL rhs { rflags[ row ].test(RowFlag::kRhsInf) ? matrix.getRightHandSides( )[ duplicate ]
+                        : rflags[ duplicate ].test(RowFlag::kRhsInf) ? matrix.getRightHandSides( )[ row ]
+                        : min(matrix.getRightHandSides( )[ row ], matrix.getRightHandSides( )[ duplicate ]) };
+               if( !lhsinf && !rhsinf && this->num.isZetaGT(lhs, rhs) )
+                  continue;
+               if( !lhsinf )
+                  matrix.modifyLeftHandSide(row, this->num, lhs);
+               if( !rhsinf )
+                  matrix.modifyRightHandSide(row, this->num, rhs);
+               problem.getRowFlags( )[ duplicate ].set(RowFlag::kRedundant);
+               ++nrows;
+            }
+         }
+         return nrows;
+      }
+
+      bool
+      isIdentical(const Problem<REAL>& problem, int first, int second) const
+      {
+         const auto& cflags = problem.getColFlags( );
+         const auto& first_data = problem.getConstraintMatrix( ).getRowCoefficients(first);
+         const auto& second_data = problem.getConstraintMatrix( ).getRowCoefficients(second);
+         int first_index = 0;
+         int second_index = 0;
+         while( true )
+         {
+            while( first_index < first_data.getLength( ) && ( cflags[ first_data.getIndices( )[ first_index ] ].test(ColFlag::kFixed)
+                                                             || this->num.isZetaZero(first_data.getValues( )[ first_index ]) ) )
+               ++first_index;
+            while( second_index < second_data.getLength( ) && ( cflags[ second_data.getIndices( )[ second_index ] ].test(ColFlag::kFixed)
+                                                               || this->num.isZetaZero(second_data.getValues( )[ second_index ]) ) )
+               ++second_index;
+            if( first_index == first_data.getLength( ) || second_index == second_data.getLength( ) )
+               return first_index == first_data.getLength( ) && second_index == second_data.getLength( );
+            if( first_data.getIndices( )[ first_index ] != second_data.getIndices( )[ second_index ]
+                || first_data.getValues( )[ first_index ] != second_data.getValues( )[ second_index ] )
+               return false;
+            ++first_index;
+            ++second_index;
+         }
+      }
+
+      /**
+       * fixes columns without objective which appear in no active row to reference values
+       * @return number of fixed columns
+       */
+      int
+      removeIsolatedColumns(Problem<REAL>& problem, const Solution<REAL>& solution) const
+      {
+         const auto& matrix = problem.getConstraintMatrix( );
+         auto& cflags = problem.getColFlags( );
+         int ncols = 0;
+         for( int col = 0; col < problem.getNCols( ); ++col )
+         {
+            if( cflags[ col ].test(ColFlag::kFixed) || !this->num.isZetaZero(problem.getObjective( ).coefficients[ col ]) )
+               continue;
+            const auto& data = matrix.getColumnCoefficients(col);
+            bool isolated = true;
+            for( int index = 0; index < data.getLength( ) && isolated; ++index )
+               isolated = problem.getRowFlags( )[ data.getIndices( )[ index ] ].test(RowFlag::kRedundant) || this->num.isZetaZero(data.getValues( )[ index ]);
+            if( !isolated )
+               continue;
+            REAL fixedval { this->get_fixed_value(problem, solution, col) };
+            cflags[ col ].unset(ColFlag::kLbInf);
+            cflags[ col ].unset(ColFlag::kUbInf);
+            problem.getLowerBounds( )[ col ] = fixedval;
+            problem.getUpperBounds( )[ col ] = fixedval;
+            cflags[ col ].set(ColFlag::kFixed);
+            ++ncols;
+         }
+         return ncols;
+      }
+
+      ModifierStatus
+      execute(SolverSettings& settings, Problem<REAL>& problem, Solution<REAL>& solution) override
+      {
+         if( solution.status == SolutionStatus::kInfeasible || solution.status == SolutionStatus::kUnbounded )
+            return ModifierStatus::kNotAdmissible;
+
+         // all kinds of simplifications form a single batch and are only checked one by one if it is rejected
+         this->fallback_batchsize = 1;
+         Batch applied_reductions { };
+         ModifierStatus status = this->template apply_batches<Batch>(settings, problem, solution, 4, 4,
+               [this, &solution](Problem<REAL>& copy, int element, Batch& batch) {
+                  int nrows = 0;
+                  int ncols = 0;
+                  switch( element )
+                  {
+                  case 0:
+                     nrows = removeFixedRows(copy);
+                     break;
+                  case 1:
+                     nrows = removeSingletonRows(copy, solution);
+                     break;
+                  case 2:
+                     nrows = removeDuplicateRows(copy);
+                     break;
+                  default:
+                     ncols = removeIsolatedColumns(copy, solution);
+                  }
+                  batch.nrows += nrows;
+                  batch.ncols += ncols;
+                  return nrows + ncols >= 1;
+               },
+               [&applied_reductions](const Batch& batch) {
+                  applied_reductions.nrows += batch.nrows;
+                  applied_reductions.ncols += batch.ncols;
+               });
+
+         if( status == ModifierStatus::kSuccessful )
+         {
+            this->ndeletedrows += applied_reductions.nrows;
+            this->nfixedvars += applied_reductions.ncols;
+         }
+         return status;
+      }
+   };
+
+} // namespace bugger
+
+#endif
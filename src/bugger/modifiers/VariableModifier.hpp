@@ -69,77 +69,31 @@ namespace bugger
                   ++batchsize;
             if( batchsize == this->parameters.nbatches - 1 )
                return ModifierStatus::kNotAdmissible;
-            batchsize /= this->parameters.nbatches;
+            batchsize = this->predict_batchsize(problem, batchsize - this->parameters.nbatches + 1,
+                                                batchsize / this->parameters.nbatches, CostModel<REAL>::Shrink::kColumns);
          }
 
-         bool admissible = false;
-         auto copy = Problem<REAL>(problem);
          Vec<std::pair<int, REAL>> applied_reductions { };
-         Vec<std::pair<int, REAL>> batches { };
-         batches.reserve(batchsize);
-
-         for( int col = copy.getNCols() - 1; col >= 0; --col )
-         {
-            if( isVariableAdmissible(copy, col) )
-            {
-               REAL fixedval { };
-               admissible = true;
-               if( solution.status == SolutionStatus::kFeasible )
-               {
-                  fixedval = solution.primal[ col ];
-                  if( copy.getColFlags( )[ col ].test(ColFlag::kIntegral) )
-                     fixedval = round(fixedval);
-               }
-               else
-               {
-                  if( copy.getColFlags( )[ col ].test(ColFlag::kIntegral) )
-                  {
-                     if( !copy.getColFlags( )[ col ].test(ColFlag::kUbInf) )
-                        fixedval = min(fixedval, this->num.epsFloor(copy.getUpperBounds( )[ col ]));
-                     if( !copy.getColFlags( )[ col ].test(ColFlag::kLbInf) )
-                        fixedval = max(fixedval, this->num.epsCeil(copy.getLowerBounds( )[ col ]));
-                  }
-                  else
-                  {
-                     if( !copy.getColFlags( )[ col ].test(ColFlag::kUbInf) )
-                        fixedval = min(fixedval, copy.getUpperBounds( )[ col ]);
-                     if( !copy.getColFlags( )[ col ].test(ColFlag::kLbInf) )
-                        fixedval = max(fixedval, copy.getLowerBounds( )[ col ]);
-                  }
-               }
-               copy.getColFlags( )[ col ].unset(ColFlag::kLbInf);
-               copy.getColFlags( )[ col ].unset(ColFlag::kUbInf);
-               copy.getLowerBounds( )[ col ] = fixedval;
-               copy.getUpperBounds( )[ col ] = fixedval;
-               batches.emplace_back(col, fixedval);
-            }
-
-            if( !batches.empty() && ( batches.size() >= batchsize || col <= 0 ) )
-            {
-               if( this->call_solver(settings, copy, solution) == BuggerStatus::kOkay )
-               {
-                  copy = Problem<REAL>(problem);
-                  for( const auto& item: applied_reductions )
-                  {
-                     copy.getColFlags( )[ item.first ].unset(ColFlag::kLbInf);
-                     copy.getColFlags( )[ item.first ].unset(ColFlag::kUbInf);
-                     copy.getLowerBounds( )[ item.first ] = item.second;
-                     copy.getUpperBounds( )[ item.first ] = item.second;
-                  }
-               }
-               else
-                  applied_reductions.insert(applied_reductions.end(), batches.begin(), batches.end());
-               batches.clear();
-            }
-         }
-
-         if( !admissible )
-            return ModifierStatus::kNotAdmissible;
-         if( applied_reductions.empty() )
-            return ModifierStatus::kUnsuccesful;
-         problem = copy;
-         this->nfixedvars += applied_reductions.size();
-         return ModifierStatus::kSuccessful;
+         ModifierStatus status = this->template apply_batches<ScratchVec<std::pair<int, REAL>>>(settings, problem, solution, problem.getNCols( ), batchsize,
+               [this, &solution](Problem<REAL>& copy, int element, ScratchVec<std::pair<int, REAL>>& batch) {
+                  int col = copy.getNCols( ) - 1 - element;
+                  if( !isVariableAdmissible(copy, col) )
+                     return false;
+                  REAL fixedval { this->get_fixed_value(copy, solution, col) };
+                  copy.getColFlags( )[ col ].unset(ColFlag::kLbInf);
+                  copy.getColFlags( )[ col ].unset(ColFlag::kUbInf);
+                  copy.getLowerBounds( )[ col ] = fixedval;
+                  copy.getUpperBounds( )[ col ] = fixedval;
+                  batch.emplace_back(col, fixedval);
+                  return true;
+               },
+               [&applied_reductions](const ScratchVec<std::pair<int, REAL>>& batch) {
+                  applied_reductions.insert(applied_reductions.end(), batch.begin(), batch.end());
+               });
+
+         if( status == ModifierStatus::kSuccessful )
+            this->nfixedvars += applied_reductions.size();
+         return status;
       }
    };
 
@@ -76,86 +76,50 @@ namespace bugger
                   ++batchsize;
             if( batchsize == this->parameters.nbatches - 1 )
                return ModifierStatus::kNotAdmissible;
-            batchsize /= this->parameters.nbatches;
+            batchsize = this->predict_batchsize(problem, batchsize - this->parameters.nbatches + 1,
+                                                batchsize / this->parameters.nbatches, CostModel<REAL>::Shrink::kNone);
          }
 
-         bool admissible = false;
-         auto copy = Problem<REAL>(problem);
-         Vec<std::pair<int, REAL>> applied_objectives { };
-         Vec<std::pair<int, REAL>> applied_lowers { };
-         Vec<std::pair<int, REAL>> applied_uppers { };
-         Vec<std::pair<int, REAL>> batches_obj { };
-         Vec<std::pair<int, REAL>> batches_lb { };
-         Vec<std::pair<int, REAL>> batches_ub { };
-         batches_obj.reserve(batchsize);
-         batches_lb.reserve(batchsize);
-         batches_ub.reserve(batchsize);
-         int batch = 0;
-
-         for( int col = 0; col < copy.getNCols( ); ++col )
-         {
-            if( isVarroundAdmissible(copy, col) )
-            {
-               admissible = true;
-               REAL lb { round(copy.getLowerBounds( )[ col ]) };
-               REAL ub { round(copy.getUpperBounds( )[ col ]) };
-               if( solution.status == SolutionStatus::kFeasible )
-               {
-                  REAL value { solution.primal[ col ] };
-                  lb = min(lb, this->num.epsFloor(value));
-                  ub = max(ub, this->num.epsCeil(value));
-               }
-               if( !this->num.isZetaIntegral(copy.getObjective( ).coefficients[ col ]) )
-               {
-                  REAL obj { round(copy.getObjective( ).coefficients[ col ]) };
-                  copy.getObjective( ).coefficients[ col ] = obj;
-                  batches_obj.emplace_back(col, obj);
-               }
-               if( !copy.getColFlags( )[ col ].test(ColFlag::kLbInf) && !this->num.isZetaEq(copy.getLowerBounds( )[ col ], lb) )
-               {
-                  copy.getLowerBounds( )[ col ] = lb;
-                  batches_lb.emplace_back(col, lb);
-               }
-               if( !copy.getColFlags( )[ col ].test(ColFlag::kUbInf) && !this->num.isZetaEq(copy.getUpperBounds( )[ col ], ub) )
-               {
-                  copy.getUpperBounds( )[ col ] = ub;
-                  batches_ub.emplace_back(col, ub);
-               }
-               ++batch;
-            }
-
-            if( batch >= 1 && ( batch >= batchsize || col >= copy.getNCols( ) - 1 ) )
-            {
-               if( this->call_solver(settings, copy, solution) == BuggerStatus::kOkay )
-               {
-                  copy = Problem<REAL>(problem);
-                  for( const auto& item: applied_objectives )
-                     copy.getObjective( ).coefficients[ item.first ] = item.second;
-                  for( const auto& item: applied_lowers )
-                     copy.getLowerBounds( )[ item.first ] = item.second;
-                  for( const auto& item: applied_uppers )
-                     copy.getUpperBounds( )[ item.first ] = item.second;
-               }
-               else
-               {
-                  applied_objectives.insert(applied_objectives.end(), batches_obj.begin(), batches_obj.end());
-                  applied_lowers.insert(applied_lowers.end(), batches_lb.begin(), batches_lb.end());
-                  applied_uppers.insert(applied_uppers.end(), batches_ub.begin(), batches_ub.end());
-               }
-               batches_obj.clear();
-               batches_lb.clear();
-               batches_ub.clear();
-               batch = 0;
-            }
-         }
-
-         if( !admissible )
-            return ModifierStatus::kNotAdmissible;
-         if( applied_objectives.empty() && applied_lowers.empty() && applied_uppers.empty() )
+         long long applied_changes = 0;
+         ModifierStatus status = this->template apply_batches<long long>(settings, problem, solution, problem.getNCols( ), batchsize,
+               [this, &solution](Problem<REAL>& copy, int col, long long& batch) {
+                  if( !isVarroundAdmissible(copy, col) )
+                     return false;
+                  REAL lb { round(copy.getLowerBounds( )[ col ]) };
+                  REAL ub { round(copy.getUpperBounds( )[ col ]) };
+                  if( solution.status == SolutionStatus::kFeasible )
+                  {
+                     REAL value { solution.primal[ col ] };
+                     lb = min(lb, this->num.epsFloor(value));
+                     ub = max(ub, this->num.epsCeil(value));
+                  }
+                  if( !this->num.isZetaIntegral(copy.getObjective( ).coefficients[ col ]) )
+                  {
+                     copy.getObjective( ).coefficients[ col ] = round(copy.getObjective( ).coefficients[ col ]);
+                     ++batch;
+                  }
+                  if( !copy.getColFlags( )[ col ].test(ColFlag::kLbInf) && !this->num.isZetaEq(copy.getLowerBounds( )[ col ], lb) )
+                  {
+                     copy.getLowerBounds( )[ col ] = lb;
+                     ++batch;
+                  }
+                  if( !copy.getColFlags( )[ col ].test(ColFlag::kUbInf) && !this->num.isZetaEq(copy.getUpperBounds( )[ col ], ub) )
+                  {
+                     copy.getUpperBounds( )[ col ] = ub;
+                     ++batch;
+                  }
+                  return true;
+               },
+               [&applied_changes](const long long& batch) {
+                  applied_changes += batch;
+               });
+
+         if( status != ModifierStatus::kSuccessful )
+            return status;
+         if( applied_changes == 0 )
             return ModifierStatus::kUnsuccesful;
-         problem = copy;
-         this->nchgcoefs += applied_objectives.size() + applied_lowers.size() + applied_uppers.size();
-         return ModifierStatus::kSuccessful;
+         this->nchgcoefs += applied_changes;
+         return status;
       }
    };
 